@@ -11,18 +11,49 @@
 
 #include "command.h"
 
+#include <array>
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 
 class Class_Command : public Command {
 public:
   Class_Command();
 
+  static constexpr std::string_view name = "class";
+  static constexpr std::string_view description =
+      "Creates a class-based header-source file pair with many options "
+      "(overrides existing headdr-source file pairs with same names)";
+  static constexpr std::string_view arguments =
+      "[names] names of files that will contain classes or names of pure "
+      "virtual functions (depending on flags)";
+  static constexpr uint16_t min_args = 1;
+  static constexpr std::array<Flag_Spec, 6> flag_schema = {{
+      {"hpp", '\0', Flag_Type::boolean, "",
+       "use .hpp header files instead of .h header files"},
+      {"parent", 'p', Flag_Type::value, "",
+       "[parent file name] specify a parent file to inhert from"},
+      {"private", '\0', Flag_Type::boolean, "", "use private inheritance"},
+      {"protected", '\0', Flag_Type::boolean, "", "use protected inheritance"},
+      {"singleton", '\0', Flag_Type::boolean, "", "create singleton"},
+      {"interface", '\0', Flag_Type::boolean, "", "create interface"},
+  }};
+  static constexpr std::array<std::string_view, 2> config_keys = {
+      "text_coloring",
+      "color_*",
+  };
+
+  /**
+   * @brief Gets index of flag in flag schema
+   *
+   * @param flag_name Flag name
+   * @return size_t
+   */
+  static consteval size_t flag(std::string_view flag_name) {
+    return flag_index(flag_schema, flag_name);
+  }
+
   uint8_t execute(const std::vector<std::string> &args,
-                  const std::vector<std::string> &flags) const override;
-  std::string get_description() const override;
-  std::string get_arguments() const override;
-  std::string get_flags() const override;
-  uint16_t get_min_args() const override;
+                  const Flags &flags) const override;
 };
\ No newline at end of file
@@ -11,9 +11,13 @@
 
 #include "../data.h"
 #include "../logger.h"
+#include "../plan.h"
+#include "flags.h"
 
 #include <cstdint>
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <vector>
 
 class Command {
@@ -21,13 +25,25 @@ protected:
   static Logger &logger;
   static Data_Manager &data_manager;
 
+  /* Per-execution arena, released in bulk once the command returns */
+  std::pmr::memory_resource *memory = std::pmr::get_default_resource();
+
+  /* Filesystem operations are recorded here and executed (or printed) once
+   * the command returns */
+  Plan *plan = nullptr;
+
+  /* Plan is only printed, nothing may be written outside of it */
+  bool dry_run = false;
+
 public:
   virtual ~Command() = default;
 
+  void set_memory_resource(std::pmr::memory_resource *_memory);
+
+  void set_plan(Plan *_plan);
+
+  void set_dry_run(const bool &_dry_run);
+
   virtual uint8_t execute(const std::vector<std::string> &args,
-                          const std::vector<std::string> &flags) const = 0;
-  virtual std::string get_description() const = 0;
-  virtual std::string get_arguments() const = 0;
-  virtual std::string get_flags() const = 0;
-  virtual uint16_t get_min_args() const = 0;
+                          const Flags &flags) const = 0;
 };
@@ -13,19 +13,50 @@
 
 #include <cstdint>
 #include <memory>
+#include <span>
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <vector>
 
-class Command_Manager {
-private:
-  std::unordered_map<std::string, std::unique_ptr<Command>> commands;
+/**
+ * @brief Compile-time description of a command, the command object itself is
+ * only constructed when it is executed
+ *
+ */
+struct Command_Entry {
+  std::string_view name;
+  uint16_t min_args;
+  std::string_view description;
+  std::string_view arguments;
+  std::span<const Flag_Spec> flag_schema;
+  std::span<const std::string_view> config_keys;
+  std::unique_ptr<Command> (*create)();
 
+  /**
+   * @brief Checks if command depends on config key ('*' suffix in declared
+   * keys matches any key with that prefix)
+   *
+   * @param key Config key
+   * @return true
+   * @return false
+   */
+  constexpr bool depends_on(std::string_view key) const {
+    for (const auto &k : config_keys) {
+      if (k.ends_with('*') ? key.starts_with(k.substr(0, k.size() - 1))
+                           : key == k)
+        return true;
+    }
+
+    return false;
+  }
+};
+
+class Command_Manager {
 public:
-  void register_command(const std::string &name,
-                        std::unique_ptr<Command> command);
-  bool exists(const std::string &name) const;
-  uint8_t execute(const std::string &name, const std::vector<std::string> &args,
-                  const std::vector<std::string> &flags) const;
-  uint16_t get_min_args(const std::string &name) const;
+  static const Command_Entry *find(std::string_view name);
+  static std::span<const Command_Entry> entries();
+  uint8_t execute(const Command_Entry &entry,
+                  const std::vector<std::string> &args, const Flags &flags,
+                  const bool &dry_run) const;
   uint8_t help_menu(const std::vector<std::string> &args) const;
 };
\ No newline at end of file
@@ -0,0 +1,44 @@
+/**
+ * @file completions_command.h
+ * @brief Outlines completions command
+ * @version 0.1
+ * @date 2025-05-18
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+
+#include "command.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class Completions_Command : public Command {
+public:
+  Completions_Command();
+
+  /* Pair names of the project (one per line), kept up to date by fpair and
+   * read by the completion scripts without running cpm */
+  static constexpr std::string_view cache_path = ".cpm/completions";
+
+  static constexpr std::string_view name = "completions";
+  static constexpr std::string_view description =
+      "Generates a shell completion script (commands and flags are built in, "
+      "pair names are read from the project's completion cache)";
+  static constexpr std::string_view arguments =
+      "[shell] bash, zsh or fish\t[path] (optional) file to write script to "
+      "(defaults to a file in ~/.config/cpm/completions)";
+  static constexpr uint16_t min_args = 1;
+  static constexpr std::array<Flag_Spec, 0> flag_schema = {};
+  static constexpr std::array<std::string_view, 2> config_keys = {
+      "text_coloring",
+      "color_*",
+  };
+
+  uint8_t execute(const std::vector<std::string> &args,
+                  const Flags &flags) const override;
+};
@@ -11,18 +11,27 @@
 
 #include "command.h"
 
+#include <array>
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 
 class Config_Command : public Command {
 public:
   Config_Command();
 
+  static constexpr std::string_view name = "config";
+  static constexpr std::string_view description =
+      "Allows access to configuration variables of CPM";
+  static constexpr std::string_view arguments =
+      "[sub command] sub command of config to execute\t[key] configuration "
+      "key to use\t[value] (only required for set sub command) value to set "
+      "key to";
+  static constexpr uint16_t min_args = 2;
+  static constexpr std::array<Flag_Spec, 0> flag_schema = {};
+  static constexpr std::array<std::string_view, 1> config_keys = {"*"};
+
   uint8_t execute(const std::vector<std::string> &args,
-                  const std::vector<std::string> &flags) const override;
-  std::string get_description() const override;
-  std::string get_arguments() const override;
-  std::string get_flags() const override;
-  uint16_t get_min_args() const override;
+                  const Flags &flags) const override;
 };
\ No newline at end of file
@@ -0,0 +1,55 @@
+/**
+ * @file find_command.h
+ * @brief Outlines find command
+ * @version 0.1
+ * @date 2025-06-10
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+
+#include "command.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class Find_Command : public Command {
+public:
+  Find_Command();
+
+  static constexpr std::string_view name = "find";
+  static constexpr std::string_view description =
+      "Finds text in src, include and tests, printing matches as path:line "
+      "(narrowed down by a trigram index kept in .cpm/search)";
+  static constexpr std::string_view arguments =
+      "[text] text to find (an ECMAScript regular expression with --regex)";
+  static constexpr uint16_t min_args = 1;
+  static constexpr std::array<Flag_Spec, 3> flag_schema = {{
+      {"regex", 'r', Flag_Type::boolean, "",
+       "treat text as a regular expression"},
+      {"ignore-case", 'i', Flag_Type::boolean, "", "ignore letter case"},
+      {"cached", 'c', Flag_Type::boolean, "",
+       "search the index as it is, without checking files for changes"},
+  }};
+  static constexpr std::array<std::string_view, 2> config_keys = {
+      "text_coloring",
+      "color_*",
+  };
+
+  /**
+   * @brief Gets index of flag in flag schema
+   *
+   * @param flag_name Flag name
+   * @return size_t
+   */
+  static consteval size_t flag(std::string_view flag_name) {
+    return flag_index(flag_schema, flag_name);
+  }
+
+  uint8_t execute(const std::vector<std::string> &args,
+                  const Flags &flags) const override;
+};
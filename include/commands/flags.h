@@ -0,0 +1,71 @@
+/**
+ * @file flags.h
+ * @brief Outlines per-command flag schemas and parsed flag sets
+ * @version 0.1
+ * @date 2025-03-02
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+enum class Flag_Type : uint8_t {
+  boolean, // --flag
+  value,   // --flag=value
+};
+
+/**
+ * @brief Declares a single flag accepted by a command
+ *
+ */
+struct Flag_Spec {
+  std::string_view name;
+  char alias; // Short alias (-a), '\0' if flag has none
+  Flag_Type type;
+  std::string_view default_value;
+  std::string_view description;
+};
+
+constexpr size_t max_flags = 32;
+
+/**
+ * @brief Gets index of flag in schema at compile time (misspelled flag names
+ * fail to compile)
+ *
+ * @param schema Flag schema
+ * @param name Flag name
+ * @return size_t
+ */
+consteval size_t flag_index(std::span<const Flag_Spec> schema,
+                            std::string_view name) {
+  for (size_t i = 0; i < schema.size(); i++)
+    if (schema[i].name == name)
+      return i;
+
+  throw "flag is not declared in schema";
+}
+
+class Flags {
+private:
+  std::span<const Flag_Spec> schema;
+  std::bitset<max_flags> present;
+  std::array<std::string_view, max_flags> values;
+
+public:
+  Flags(std::span<const Flag_Spec> _schema = {});
+
+  bool parse(std::string_view raw);
+
+  void set(size_t flag, std::string_view value = {});
+
+  bool has(size_t flag) const;
+
+  std::string_view value(size_t flag) const;
+};
\ No newline at end of file
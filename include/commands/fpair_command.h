@@ -11,18 +11,50 @@
 
 #include "command.h"
 
+#include <array>
 #include <cstdint>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 class Fpair_Command : public Command {
+private:
+  uint8_t remove_pairs(const std::vector<std::string> &patterns) const;
+
+  void update_completions(std::span<const std::string> created,
+                          std::span<const std::string_view> removed) const;
+
 public:
   Fpair_Command();
 
+  static constexpr std::string_view name = "fpair";
+  static constexpr std::string_view description =
+      "Creates a header-source file pair";
+  static constexpr std::string_view arguments =
+      "[sub command] sub command of fpair to execute\t[file names] names of "
+      "file pairs to create or remove (separated by spaces, remove also "
+      "takes glob patterns like 'net/*' or '**/legacy_*')";
+  static constexpr uint16_t min_args = 2;
+  static constexpr std::array<Flag_Spec, 1> flag_schema = {{
+      {"hpp", '\0', Flag_Type::boolean, "",
+       "use .hpp header files instead of .h header files"},
+  }};
+  static constexpr std::array<std::string_view, 2> config_keys = {
+      "text_coloring",
+      "color_*",
+  };
+
+  /**
+   * @brief Gets index of flag in flag schema
+   *
+   * @param flag_name Flag name
+   * @return size_t
+   */
+  static consteval size_t flag(std::string_view flag_name) {
+    return flag_index(flag_schema, flag_name);
+  }
+
   uint8_t execute(const std::vector<std::string> &args,
-                  const std::vector<std::string> &flags) const override;
-  std::string get_description() const override;
-  std::string get_arguments() const override;
-  std::string get_flags() const override;
-  uint16_t get_min_args() const override;
+                  const Flags &flags) const override;
 };
\ No newline at end of file
@@ -11,8 +11,12 @@
 
 #include "command.h"
 
+#include <array>
 #include <cstdint>
+#include <filesystem>
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <vector>
 
 const std::vector<std::string> supported_structures = {
@@ -20,14 +24,78 @@ const std::vector<std::string> supported_structures = {
     "simple",
 };
 
+/**
+ * @brief Settings shared by every project created by one init invocation
+ *
+ */
+struct Project_Settings {
+  std::string lang;
+  std::string structure;
+  bool git_support;
+  std::string lang_version;
+  std::string cmake_version; // Empty for simple structure
+};
+
 class Init_Command : public Command {
+private:
+  static void create_project(Plan &plan, const std::filesystem::path &root,
+                             std::string_view project_name,
+                             const Project_Settings &settings);
+
+  static bool
+  read_workspace_members(const std::string &spec,
+                         std::vector<std::filesystem::path> &members,
+                         std::pmr::memory_resource *memory);
+
+  uint8_t create_workspace(const std::string &spec,
+                           const Project_Settings &settings) const;
+
 public:
   Init_Command();
 
+  static constexpr std::string_view name = "init";
+  static constexpr std::string_view description =
+      "Initializes a new c/cpp project in working directory";
+  static constexpr std::string_view arguments =
+      "[language] language project is based in";
+  static constexpr uint16_t min_args = 1;
+  static constexpr std::array<Flag_Spec, 7> flag_schema = {{
+      {"std", 's', Flag_Type::value, "",
+       "[language standard] specify a specific language standard to use "
+       "instead of C23 or C++23"},
+      {"name", 'n', Flag_Type::value, "",
+       "[project name] name of project (skips prompt)"},
+      {"structure", '\0', Flag_Type::value, "",
+       "[structure] project structure, executable or simple (skips prompt)"},
+      {"git", '\0', Flag_Type::boolean, "", "add git support (skips prompt)"},
+      {"preset", '\0', Flag_Type::value, "",
+       "[preset name] use structure, git support and language standard from "
+       "preset_[preset name]_structure/_git/_std config keys"},
+      {"no-prompt", '\0', Flag_Type::boolean, "",
+       "never prompt, fail if project name is missing and use defaults for "
+       "everything else"},
+      {"workspace", 'w', Flag_Type::value, "",
+       "[projects] create every project in a comma-separated list (or a file "
+       "listing one per line), plus a top-level CMakeLists.txt"},
+  }};
+  static constexpr std::array<std::string_view, 5> config_keys = {
+      "text_coloring",
+      "color_*",
+      "default_structure",
+      "cmake_*",
+      "preset_*",
+  };
+
+  /**
+   * @brief Gets index of flag in flag schema
+   *
+   * @param flag_name Flag name
+   * @return size_t
+   */
+  static consteval size_t flag(std::string_view flag_name) {
+    return flag_index(flag_schema, flag_name);
+  }
+
   uint8_t execute(const std::vector<std::string> &args,
-                  const std::vector<std::string> &flags) const override;
-  std::string get_description() const override;
-  std::string get_arguments() const override;
-  std::string get_flags() const override;
-  uint16_t get_min_args() const override;
+                  const Flags &flags) const override;
 };
\ No newline at end of file
@@ -0,0 +1,53 @@
+/**
+ * @file stats_command.h
+ * @brief Outlines stats command
+ * @version 0.1
+ * @date 2025-06-01
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+
+#include "command.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class Stats_Command : public Command {
+public:
+  Stats_Command();
+
+  static constexpr std::string_view name = "stats";
+  static constexpr std::string_view description =
+      "Shows wall time percentiles (p50/p95/p99) and trends of recent runs "
+      "per command, read from ~/.config/cpm/history";
+  static constexpr std::string_view arguments =
+      "[commands] (optional) commands to show, every recorded one by default";
+  static constexpr uint16_t min_args = 0;
+  static constexpr std::array<Flag_Spec, 1> flag_schema = {{
+      {"export", 'e', Flag_Type::value, "",
+       "[path] write the statistics as a node_exporter textfile (.prom) to "
+       "path"},
+  }};
+  static constexpr std::array<std::string_view, 2> config_keys = {
+      "text_coloring",
+      "color_*",
+  };
+
+  /**
+   * @brief Gets index of flag in flag schema
+   *
+   * @param flag_name Flag name
+   * @return size_t
+   */
+  static consteval size_t flag(std::string_view flag_name) {
+    return flag_index(flag_schema, flag_name);
+  }
+
+  uint8_t execute(const std::vector<std::string> &args,
+                  const Flags &flags) const override;
+};
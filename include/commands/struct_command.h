@@ -11,18 +11,42 @@
 
 #include "command.h"
 
+#include <array>
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 
 class Struct_Command : public Command {
 public:
   Struct_Command();
 
+  static constexpr std::string_view name = "struct";
+  static constexpr std::string_view description =
+      "Creates a struct based header-source file pair";
+  static constexpr std::string_view arguments =
+      "[names] names of files that will contain structs";
+  static constexpr uint16_t min_args = 1;
+  static constexpr std::array<Flag_Spec, 2> flag_schema = {{
+      {"hpp", '\0', Flag_Type::boolean, "",
+       "use .hpp header files instead of .h header files"},
+      {"ntypedef", '\0', Flag_Type::boolean, "", "don't use typedef keyword"},
+  }};
+  static constexpr std::array<std::string_view, 2> config_keys = {
+      "text_coloring",
+      "color_*",
+  };
+
+  /**
+   * @brief Gets index of flag in flag schema
+   *
+   * @param flag_name Flag name
+   * @return size_t
+   */
+  static consteval size_t flag(std::string_view flag_name) {
+    return flag_index(flag_schema, flag_name);
+  }
+
   uint8_t execute(const std::vector<std::string> &args,
-                  const std::vector<std::string> &flags) const override;
-  std::string get_description() const override;
-  std::string get_arguments() const override;
-  std::string get_flags() const override;
-  uint16_t get_min_args() const override;
+                  const Flags &flags) const override;
 };
\ No newline at end of file
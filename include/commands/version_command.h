@@ -11,14 +11,24 @@
 
 #include "command.h"
 
+#include <array>
+#include <string_view>
+
 class Version_Command : public Command {
 public:
   Version_Command();
 
+  static constexpr std::string_view name = "version";
+  static constexpr std::string_view description =
+      "Logs installed version of CPM";
+  static constexpr std::string_view arguments = "None";
+  static constexpr uint16_t min_args = 0;
+  static constexpr std::array<Flag_Spec, 0> flag_schema = {};
+  static constexpr std::array<std::string_view, 2> config_keys = {
+      "text_coloring",
+      "color_*",
+  };
+
   uint8_t execute(const std::vector<std::string> &args,
-                  const std::vector<std::string> &flags) const override;
-  std::string get_description() const override;
-  std::string get_arguments() const override;
-  std::string get_flags() const override;
-  uint16_t get_min_args() const override;
+                  const Flags &flags) const override;
 };
\ No newline at end of file
@@ -0,0 +1,54 @@
+/**
+ * @file watch_command.h
+ * @brief Outlines watch command
+ * @version 0.1
+ * @date 2025-06-08
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+
+#include "command.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class Watch_Command : public Command {
+public:
+  Watch_Command();
+
+  static constexpr std::string_view name = "watch";
+  static constexpr std::string_view description =
+      "Keeps the project's file index (.cpm/index) and completion cache up to "
+      "date while files change, so other commands don't walk the project";
+  static constexpr std::string_view arguments = "None";
+  static constexpr uint16_t min_args = 0;
+  static constexpr std::array<Flag_Spec, 2> flag_schema = {{
+      {"once", 'o', Flag_Type::boolean, "",
+       "build index and completion cache once instead of watching"},
+      {"debounce", 'd', Flag_Type::value, "100",
+       "[milliseconds] quiet time after which a burst of changes is applied "
+       "(100 by default)"},
+  }};
+  static constexpr std::array<std::string_view, 2> config_keys = {
+      "text_coloring",
+      "color_*",
+  };
+
+  /**
+   * @brief Gets index of flag in flag schema
+   *
+   * @param flag_name Flag name
+   * @return size_t
+   */
+  static consteval size_t flag(std::string_view flag_name) {
+    return flag_index(flag_schema, flag_name);
+  }
+
+  uint8_t execute(const std::vector<std::string> &args,
+                  const Flags &flags) const override;
+};
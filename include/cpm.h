@@ -0,0 +1,49 @@
+/**
+ * @file cpm.h
+ * @brief Embedding API of libcpm, runs cpm commands in-process
+ * @version 0.1
+ * @date 2025-05-25
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+
+#include "logger.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace cpm {
+/**
+ * @brief How a command is run, everything the cpm binary takes from its
+ * working directory and argv
+ *
+ */
+struct Options {
+  /* Project root relative paths resolve against (the working directory if
+   * empty) */
+  std::filesystem::path root;
+
+  /* Receives logged lines (the console if nullptr), prompts are answered
+   * with an empty line and y/n prompts with no */
+  Log_Sink *sink = nullptr;
+
+  /* Only log the filesystem operations the command planned */
+  bool dry_run = false;
+
+  /* Keep written files in memory (reads fall through to disk), dumped below
+   * dump_folder afterwards if it isn't empty */
+  bool in_memory = false;
+  std::filesystem::path dump_folder;
+
+  /* Write config the command changed back to ~/.config/cpm/cpm.data */
+  bool save_config = true;
+};
+
+uint8_t run(std::string_view command, std::span<const std::string> arguments,
+            const Options &options = {});
+} // namespace cpm
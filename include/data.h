@@ -9,23 +9,37 @@
  */
 #pragma once
 
+#include <filesystem>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 
+std::filesystem::path get_store_location();
+
 class Data_Manager {
 private:
   Data_Manager() {}
 
-public:
-  std::unordered_map<std::string, std::string> config;
+  std::unordered_map<std::string, std::string> config; // As last written
+  std::mutex mutex; // Commands running in parallel share the config
+  bool loaded = false;
+
+  void read();
 
+public:
   Data_Manager(const Data_Manager &obj) = delete;
 
   static Data_Manager &get();
 
-  void read();
-
   void write();
 
+  void discard();
+
   bool config_has_key(const std::string &key);
+
+  std::string get_value(const std::string &key);
+
+  void set_value(const std::string &key, const std::string &value);
+
+  void remove_value(const std::string &key);
 };
\ No newline at end of file
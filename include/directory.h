@@ -11,10 +11,27 @@
 
 #include <filesystem>
 #include <fstream>
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace directory {
+/**
+ * @brief Path relative to an open directory handle
+ *
+ */
+struct At_Path {
+  int dirfd;        // Handle of project root, src/, include/ (or AT_FDCWD)
+  const char *path; // Null terminated, stays valid for the rest of the run
+};
+
+At_Path at(const std::filesystem::path &path);
+
+void hold_handles();
+
+void forget_handles();
+
 bool has_folder(const std::filesystem::path &path);
 
 bool has_file(const std::filesystem::path &path);
@@ -27,10 +44,26 @@ void create_file(const std::filesystem::path &path);
 
 void destroy_file(const std::filesystem::path &path);
 
+bool skipped_folder(std::string_view name, size_t depth);
+
+bool listed(std::string_view relative_path, const bool &recursive);
+
+bool split_pair_path(std::string_view file, std::string_view &name,
+                     std::string_view &structured_name);
+
+std::pmr::vector<std::pmr::string>
+list_files(const std::filesystem::path &folder,
+           std::pmr::memory_resource *memory);
+
+std::pmr::vector<std::pmr::string>
+list_pair_files(std::pmr::memory_resource *memory);
+
 std::string get_structure();
 
 std::string get_extension();
 
+void forget_extension();
+
 std::filesystem::path get_structured_header_path(const std::string &name,
                                                  const bool &hpp = false);
 
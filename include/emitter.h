@@ -0,0 +1,54 @@
+/**
+ * @file emitter.h
+ * @brief Outlines emitter.cpp
+ * @version 0.1
+ * @date 2025-03-23
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <initializer_list>
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief File contents represented as a list of fragments (views of static
+ * template text and names) that are written with writev, without ever being
+ * concatenated
+ *
+ */
+class Emitter {
+private:
+  std::pmr::vector<std::string_view> fragments;
+  size_t total_size = 0;
+
+public:
+  Emitter(std::pmr::memory_resource *memory = std::pmr::get_default_resource());
+
+  Emitter &append(std::string_view fragment);
+
+  Emitter &append(std::initializer_list<std::string_view> parts);
+
+  Emitter &line(std::initializer_list<std::string_view> parts);
+
+  Emitter &appended_line(std::initializer_list<std::string_view> parts);
+
+  void reserve(size_t count);
+
+  size_t size() const;
+
+  std::span<const std::string_view> get_fragments() const;
+
+  void render(std::string &out) const;
+
+  bool write_to(const std::filesystem::path &path, const bool &append) const;
+
+  bool write_to(int dirfd, const char *path, const bool &append) const;
+};
\ No newline at end of file
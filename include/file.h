@@ -9,25 +9,29 @@
  */
 #pragma once
 
+#include "emitter.h"
+
 #include <filesystem>
-#include <fstream>
+#include <initializer_list>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 class File {
 private:
-  static std::ofstream writer;
-  static std::ifstream reader;
-
   std::filesystem::path path;
 
 public:
   File(const std::filesystem::path &_path);
-  ~File();
 
-  void write(const std::vector<std::string> &lines);
+  void write(std::span<const std::string_view> lines);
+  void write(std::initializer_list<std::string_view> lines);
+  void write(const Emitter &emitter);
 
-  void load(const std::vector<std::string> &lines);
+  void load(std::span<const std::string_view> lines);
+  void load(std::initializer_list<std::string_view> lines);
+  void load(const Emitter &emitter);
 
   void remove();
 
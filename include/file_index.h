@@ -0,0 +1,66 @@
+/**
+ * @file file_index.h
+ * @brief Outlines file_index.cpp
+ * @version 0.1
+ * @date 2025-06-08
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <set>
+#include <string>
+#include <string_view>
+
+namespace file_index {
+/* Kept up to date by cpm watch, read by every listing of the project */
+constexpr std::string_view index_path = ".cpm/index";
+
+/**
+ * @brief Modification time of a directory, it changes whenever an entry is
+ * added to or removed from it
+ *
+ */
+struct Stamp {
+  int64_t seconds = 0;
+  int64_t nanoseconds = 0;
+
+  bool operator==(const Stamp &) const = default;
+};
+
+/**
+ * @brief Files of the project (skipped like listings skip them) and the
+ * folders they were listed from, paths relative to project root
+ *
+ */
+struct Index {
+  std::set<std::string, std::less<>> files;
+  std::map<std::string, Stamp, std::less<>> folders; // "." for root
+
+  bool add_tree(std::string_view folder);
+
+  void remove_tree(std::string_view folder);
+
+  bool stamp(std::string_view folder);
+
+  bool fresh() const;
+
+  std::string text() const;
+
+  bool save() const;
+
+  bool load();
+};
+
+const Index *current();
+
+void forget();
+
+bool list(const std::filesystem::path &folder, const bool &recursive,
+          const std::function<void(std::string_view)> &on_file);
+} // namespace file_index
@@ -0,0 +1,52 @@
+/**
+ * @file history.h
+ * @brief Outlines history.cpp
+ * @version 0.1
+ * @date 2025-06-01
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+#include <vector>
+
+namespace history {
+/* Runs kept in the history file, the oldest one is overwritten first */
+constexpr uint32_t capacity = 4096;
+
+/**
+ * @brief One run of a command, stored as is (fixed size, so the file is a
+ * ring of records)
+ *
+ */
+struct Record {
+  int64_t time = 0;         // End of run, milliseconds since the epoch
+  uint64_t wall_time = 0;   // Microseconds
+  uint64_t read_calls = 0;  // Read-like system calls of the process
+  uint64_t write_calls = 0; // Write-like system calls of the process
+  uint64_t read_bytes = 0;
+  uint64_t write_bytes = 0;
+  uint16_t arg_count = 0;
+  uint8_t exit_code = 0;
+  char command[21] = {}; // Cut to fit, always null-terminated
+
+  void set_command(std::string_view name);
+
+  std::string_view get_command() const;
+};
+
+static_assert(sizeof(Record) == 72, "history records must keep their size");
+
+std::filesystem::path location();
+
+void count_io(Record &record);
+
+bool append(const Record &record);
+
+std::vector<Record> read();
+} // namespace history
@@ -0,0 +1,121 @@
+/**
+ * @file io_executor.h
+ * @brief Outlines io_executor.cpp
+ * @version 0.1
+ * @date 2025-04-06
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+
+#include "task.h"
+
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+constexpr size_t default_io_workers = 4;
+
+/**
+ * @brief Overlaps blocking filesystem operations of coroutines driven by one
+ * thread, operations run on worker threads while coroutines are only ever
+ * resumed on the thread calling run()
+ *
+ */
+class IO_Executor {
+private:
+  std::mutex mutex;
+  std::condition_variable jobs_ready, resumes_ready;
+  std::deque<std::function<void()>> jobs;
+  std::deque<std::coroutine_handle<>> resumes;
+
+  std::vector<std::thread> workers; // Started on demand
+  size_t idle_workers = 0;
+  size_t max_workers;
+  bool stopping = false;
+
+  void post(std::function<void()> job);
+
+  void resume_later(std::coroutine_handle<> handle);
+
+  void resume_next();
+
+  void work();
+
+  /**
+   * @brief Suspends coroutine while operation runs on a worker thread
+   *
+   * @tparam Operation
+   */
+  template <typename Operation> struct IO_Awaiter {
+    using Result = std::invoke_result_t<Operation &>;
+
+    IO_Executor &executor;
+    Operation operation;
+    std::optional<Result> result;
+    std::exception_ptr exception;
+
+    bool await_ready() const noexcept { return false; }
+
+    void await_suspend(std::coroutine_handle<> handle) {
+      executor.post([this, handle] {
+        try {
+          result.emplace(operation());
+        } catch (...) {
+          exception = std::current_exception();
+        }
+
+        executor.resume_later(handle);
+      });
+    }
+
+    Result await_resume() {
+      if (exception)
+        std::rethrow_exception(exception);
+
+      return std::move(*result);
+    }
+  };
+
+public:
+  IO_Executor(size_t _max_workers = default_io_workers);
+  ~IO_Executor();
+
+  /**
+   * @brief Runs blocking operation on a worker thread (it must not log, the
+   * awaiting coroutine is resumed on the driving thread with its result)
+   *
+   * @tparam Operation
+   * @param operation Operation
+   * @return IO_Awaiter<Operation>
+   */
+  template <typename Operation> IO_Awaiter<Operation> io(Operation operation) {
+    return {*this, std::move(operation), std::nullopt, nullptr};
+  }
+
+  /**
+   * @brief Drives task (and every coroutine it awaits) to completion on the
+   * calling thread
+   *
+   * @tparam T
+   * @param task Task
+   * @return T
+   */
+  template <typename T> T run(Task<T> task) {
+    task.start();
+
+    while (!task.done())
+      resume_next();
+
+    return task.result();
+  }
+};
\ No newline at end of file
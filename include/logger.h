@@ -9,10 +9,34 @@
  */
 #pragma once
 
+#include "process.h"
+
+#include <chrono>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
+class Progress;
+
+/**
+ * @brief Receives logged lines instead of the console (see Logger::set_sink)
+ *
+ */
+class Log_Sink {
+public:
+  virtual ~Log_Sink() = default;
+
+  /**
+   * @brief Receives one logged line
+   *
+   * @param mtype Message type ("success", "error", "warning", "prompt",
+   * "executing" or the type of a custom line)
+   * @param message Text (without prefix, count and colors)
+   */
+  virtual void line(std::string_view mtype, std::string_view message) = 0;
+};
+
 class Logger {
 private:
   Logger() {}
@@ -45,6 +69,14 @@ public:
 
   void disable_coloring();
 
+  void set_sink(Log_Sink *sink);
+
+  Log_Sink *sink() const;
+
+  void set_progress(Progress *progress);
+
+  Progress *progress() const;
+
   void flush_buffer() const;
 
   void handle_logger_count();
@@ -64,10 +96,13 @@ public:
   void custom(const std::string &message, const std::string &mtype,
               const std::string &color);
 
+  void output(const std::string &message);
+
   std::string prompt(const std::string &message);
 
   bool prompt_yn(const std::string &message);
 
-  bool execute(const std::string &command,
-               const bool &must_populate_file = true);
+  process::Result execute(const std::vector<std::string> &argv,
+                          const std::chrono::milliseconds &timeout =
+                              std::chrono::milliseconds::zero());
 };
\ No newline at end of file
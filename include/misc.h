@@ -11,7 +11,9 @@
 
 #include <filesystem>
 #include <fstream>
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace misc {
@@ -21,7 +23,9 @@ bool vector_contains(const std::vector<std::string> &vector,
 std::vector<std::string> split_string(const std::string &s,
                                       const std::string &delimiter);
 
-std::string get_flag_value(const std::string &flag);
+std::pmr::vector<std::string_view>
+split_string(std::string_view s, std::string_view delimiter,
+             std::pmr::memory_resource *memory);
 
 bool ofstream_open(const std::ofstream &_ofstream);
 
@@ -63,4 +67,8 @@ void set_relative_path(std::string &p, const std::filesystem::path &p1,
 
 void replace_string_instances(std::string &s, const std::string &i1,
                               const std::string &i2);
+
+bool has_token(std::string_view text, std::string_view token);
+
+bool glob_match(std::string_view pattern, std::string_view text);
 } // namespace misc
@@ -0,0 +1,107 @@
+/**
+ * @file paths.h
+ * @brief Outlines paths.cpp
+ * @version 0.1
+ * @date 2025-03-16
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace paths {
+/**
+ * @brief Iterates over the '/' separated segments of a path without copying
+ * them (empty segments are skipped)
+ *
+ */
+class Segment_Iterator {
+private:
+  std::string_view segment;
+  std::string_view rest;
+
+  /**
+   * @brief Moves to the next non-empty segment in rest
+   *
+   */
+  void next() {
+    while (!rest.empty() && rest.front() == '/')
+      rest.remove_prefix(1);
+
+    const size_t end = rest.find('/');
+    segment = rest.substr(0, end);
+    rest.remove_prefix(end == std::string_view::npos ? rest.size() : end);
+  }
+
+public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = std::string_view;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const std::string_view *;
+  using reference = const std::string_view &;
+
+  Segment_Iterator() = default;
+  explicit Segment_Iterator(std::string_view path) : rest(path) { next(); }
+
+  reference operator*() const { return segment; }
+  pointer operator->() const { return &segment; }
+
+  Segment_Iterator &operator++() {
+    next();
+    return *this;
+  }
+
+  Segment_Iterator operator++(int) {
+    Segment_Iterator old = *this;
+    next();
+    return old;
+  }
+
+  bool operator==(const Segment_Iterator &other) const {
+    return segment.empty() == other.segment.empty() &&
+           (segment.empty() || segment.data() == other.segment.data());
+  }
+};
+
+/**
+ * @brief Range over the segments of a path
+ *
+ */
+struct Segments {
+  std::string_view path;
+
+  Segment_Iterator begin() const { return Segment_Iterator(path); }
+  Segment_Iterator end() const { return {}; }
+};
+
+size_t segment_count(std::string_view path);
+
+size_t common_segments(std::string_view p1, std::string_view p2);
+
+std::string_view skip_segments(std::string_view path, size_t count);
+
+std::string_view parent(std::string_view path);
+
+const std::string &absolute(const std::filesystem::path &path);
+
+void forget();
+
+std::optional<std::string_view>
+root_relative(const std::filesystem::path &path);
+
+void set_root(const std::filesystem::path &path);
+
+bool has_root();
+
+const std::string &root();
+
+void append_relative(std::string &out, std::string_view from_dir,
+                     std::string_view to);
+} // namespace paths
\ No newline at end of file
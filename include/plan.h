@@ -0,0 +1,151 @@
+/**
+ * @file plan.h
+ * @brief Outlines plan.cpp
+ * @version 0.1
+ * @date 2025-04-13
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+
+#include "emitter.h"
+#include "io_executor.h"
+#include "progress.h"
+#include "task.h"
+#include "uring.h"
+
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <map>
+#include <memory_resource>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class Op_Type : uint8_t {
+  mkdir,  // Create directory (and its parents)
+  create, // Create file if it doesn't exist
+  write,  // Overwrite file
+  append, // Append to file
+  patch,  // Replace first occurrence of text in file
+  remove, // Remove file
+};
+
+/**
+ * @brief Filesystem operations recorded by a command, merged per path so that
+ * executing the plan touches every path once
+ *
+ */
+class Plan {
+private:
+  /**
+   * @brief Change to file contents, in the order it was recorded
+   *
+   */
+  struct Edit {
+    Op_Type type; // append or patch
+    Emitter content;
+    std::string_view find, replace;
+  };
+
+  /**
+   * @brief Merged state of one file
+   *
+   */
+  struct File_Plan {
+    bool created = false;   // File must exist afterwards
+    bool truncated = false; // Edits start from empty contents
+    bool replaced = false;  // Written to a temporary file renamed over it
+    bool removed = false;
+    std::pmr::deque<Edit> edits;
+
+    File_Plan(std::pmr::memory_resource *memory) : edits(memory) {}
+  };
+
+  /**
+   * @brief Result of bringing one file to its planned state
+   *
+   */
+  enum class Outcome : uint8_t {
+    failed,
+    changed,
+    unchanged, // Already in its planned state, it wasn't touched
+  };
+
+  /**
+   * @brief Number of files by result of execution
+   *
+   */
+  struct Summary {
+    size_t written = 0;
+    size_t unchanged = 0;
+    size_t removed = 0;
+  };
+
+  std::pmr::memory_resource *memory;
+
+  /* Keys are interned absolute paths, ordered so siblings are executed
+   * together */
+  std::pmr::map<std::string_view, File_Plan> files;
+  std::pmr::set<std::string_view> folders;
+  std::string_view success_message; // Logged once every file is executed
+
+  File_Plan &at(const std::filesystem::path &path);
+
+  Emitter &append_edit(File_Plan &file);
+
+  std::pmr::vector<std::string_view> leaf_folders() const;
+
+  static Op_Type final_op(const File_Plan &file);
+
+  static std::string render(std::string_view path, const File_Plan &file);
+
+  static bool unchanged(std::string_view path, const File_Plan &file);
+
+  static Outcome apply(std::string_view path, const File_Plan &file);
+
+  static bool record(Outcome outcome, std::string_view path,
+                     const File_Plan &file, Summary &summary,
+                     Progress &progress);
+
+  static bool batchable(const File_Plan &file);
+
+  bool create_folders(Uring &ring) const;
+
+  Task<bool> execute_file(IO_Executor &executor, const std::string &root,
+                          std::string_view path, const File_Plan &file,
+                          Summary &summary, Progress &progress) const;
+
+public:
+  Plan(std::pmr::memory_resource *_memory = std::pmr::get_default_resource());
+
+  std::string_view keep(std::string_view text);
+
+  void mkdir(const std::filesystem::path &path);
+
+  void create(const std::filesystem::path &path);
+
+  Emitter &write(const std::filesystem::path &path);
+
+  Emitter &append(const std::filesystem::path &path);
+
+  Emitter &replace(const std::filesystem::path &path);
+
+  void patch(const std::filesystem::path &path, std::string_view find,
+             std::string_view replace);
+
+  void remove(const std::filesystem::path &path, const bool &listed = false);
+
+  void on_success(std::string_view message);
+
+  bool exists(const std::filesystem::path &path) const;
+
+  std::string contents(const std::filesystem::path &path) const;
+
+  void print() const;
+
+  bool execute() const;
+};
\ No newline at end of file
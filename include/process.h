@@ -0,0 +1,31 @@
+/**
+ * @file process.h
+ * @brief Outlines process.cpp
+ * @version 0.1
+ * @date 2025-03-09
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace process {
+/**
+ * @brief Outcome of a finished (or killed) child process
+ *
+ */
+struct Result {
+  int exit_code = -1; // -1 if process could not be spawned or waited for
+  bool timed_out = false;
+  std::string out;
+  std::string err;
+};
+
+Result run(const std::vector<std::string> &argv,
+           const std::chrono::milliseconds &timeout =
+               std::chrono::milliseconds::zero());
+} // namespace process
\ No newline at end of file
@@ -0,0 +1,57 @@
+/**
+ * @file progress.h
+ * @brief Outlines progress.cpp
+ * @version 0.1
+ * @date 2025-05-11
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+constexpr std::chrono::milliseconds progress_redraw_interval(50);
+
+/**
+ * @brief Single status line (count, rate, ETA and current item) redrawn in
+ * place while a multi-item operation runs, at most once per redraw interval
+ * (only enabled when stdout is a terminal, Logger suppresses success and
+ * custom lines while it is shown, warnings and errors are still printed in
+ * full above it)
+ *
+ */
+class Progress {
+private:
+  using Clock = std::chrono::steady_clock;
+
+  std::string label;
+  size_t total;
+  size_t count = 0;
+  std::string item;
+
+  Clock::time_point start, last_draw;
+  unsigned short columns = 80;
+  bool enabled = false;
+  bool drawn = false;
+
+  void draw();
+
+public:
+  Progress(std::string_view _label, size_t _total);
+  ~Progress();
+
+  Progress(const Progress &) = delete;
+  Progress &operator=(const Progress &) = delete;
+
+  bool active() const;
+
+  void advance(std::string_view _item, size_t done = 1);
+
+  void clear();
+
+  void finish();
+};
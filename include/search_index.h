@@ -0,0 +1,88 @@
+/**
+ * @file search_index.h
+ * @brief Outlines search_index.cpp
+ * @version 0.1
+ * @date 2025-06-10
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+
+#include "file_index.h"
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace search_index {
+/* Read by cpm find, updated by it before every search */
+constexpr std::string_view index_path = ".cpm/search";
+
+/* Folders whose files are indexed (relative to project root) */
+constexpr std::array<std::string_view, 3> indexed_folders = {"src", "include",
+                                                             "tests"};
+
+/* Larger files are listed, but never searched */
+constexpr uint64_t max_file_size = 4 * 1024 * 1024;
+
+/**
+ * @brief Indexed file, its trigrams are read again once its modification
+ * time or size changes
+ *
+ */
+struct File {
+  std::string path; // Relative to project root, empty once the id is dead
+  file_index::Stamp modified;
+  uint64_t size = 0;
+  bool text = false; // Binary and oversized files are never searched
+};
+
+/**
+ * @brief Posting list of one trigram (ids of the files containing it),
+ * delta and varint encoded in the index's posting data
+ *
+ */
+struct Posting_List {
+  uint32_t trigram = 0;
+  uint32_t count = 0;
+  size_t offset = 0;
+  size_t size = 0;
+};
+
+/**
+ * @brief Trigram index of the files in indexed_folders, a file's id is its
+ * position in files
+ *
+ */
+class Index {
+private:
+  std::string postings;            // Encoded posting lists, back to back
+  std::vector<Posting_List> lists; // Sorted by trigram
+
+  void compact();
+
+public:
+  std::vector<File> files;
+
+  bool load();
+
+  bool save() const;
+
+  size_t update();
+
+  std::vector<uint32_t> candidates(std::span<const uint32_t> trigrams) const;
+
+  size_t trigram_count() const { return lists.size(); }
+};
+
+void trigrams(std::string_view text, std::vector<uint32_t> &out);
+
+std::vector<uint32_t> required_trigrams(std::string_view pattern,
+                                        const bool &regex);
+
+char fold(char c);
+} // namespace search_index
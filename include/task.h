@@ -0,0 +1,227 @@
+/**
+ * @file task.h
+ * @brief Lazily started coroutine tasks and joining of concurrent tasks
+ * @version 0.1
+ * @date 2025-04-06
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <optional>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Coroutine producing a T, starts when awaited (or started by an
+ * executor) and resumes its awaiter when finished
+ *
+ * @tparam T Result type
+ */
+template <typename T> class Task {
+public:
+  struct promise_type {
+    std::optional<T> value;
+    std::exception_ptr exception;
+    std::coroutine_handle<> continuation = std::noop_coroutine();
+
+    /**
+     * @brief Transfers control to the awaiting coroutine when task finishes
+     *
+     */
+    struct Final_Awaiter {
+      bool await_ready() const noexcept { return false; }
+
+      std::coroutine_handle<>
+      await_suspend(std::coroutine_handle<promise_type> handle) noexcept {
+        return handle.promise().continuation;
+      }
+
+      void await_resume() const noexcept {}
+    };
+
+    Task get_return_object() {
+      return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    Final_Awaiter final_suspend() const noexcept { return {}; }
+
+    void return_value(T _value) { value.emplace(std::move(_value)); }
+    void unhandled_exception() { exception = std::current_exception(); }
+  };
+
+private:
+  std::coroutine_handle<promise_type> handle;
+
+  explicit Task(std::coroutine_handle<promise_type> _handle)
+      : handle(_handle) {}
+
+public:
+  Task(Task &&other) noexcept : handle(std::exchange(other.handle, {})) {}
+
+  Task &operator=(Task &&other) noexcept {
+    if (this != &other) {
+      if (handle)
+        handle.destroy();
+
+      handle = std::exchange(other.handle, {});
+    }
+
+    return *this;
+  }
+
+  ~Task() {
+    if (handle)
+      handle.destroy();
+  }
+
+  /**
+   * @brief Runs task until its first suspension
+   *
+   */
+  void start() { handle.resume(); }
+
+  bool done() const { return handle.done(); }
+
+  /**
+   * @brief Gets result of finished task (rethrows if task threw)
+   *
+   * @return T
+   */
+  T result() {
+    if (handle.promise().exception)
+      std::rethrow_exception(handle.promise().exception);
+
+    return std::move(*handle.promise().value);
+  }
+
+  bool await_ready() const noexcept { return false; }
+
+  std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) {
+    handle.promise().continuation = awaiting;
+    return handle;
+  }
+
+  T await_resume() { return result(); }
+
+  /**
+   * @brief Awaits task without taking (or rethrowing) its result
+   *
+   * @return auto
+   */
+  auto completion() {
+    struct Completion_Awaiter {
+      Task &task;
+
+      bool await_ready() const noexcept { return false; }
+
+      std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) {
+        return task.await_suspend(awaiting);
+      }
+
+      void await_resume() const noexcept {}
+    };
+
+    return Completion_Awaiter{*this};
+  }
+};
+
+/**
+ * @brief Coroutine that starts immediately and frees itself when finished
+ *
+ */
+struct Detached_Task {
+  struct promise_type {
+    Detached_Task get_return_object() const { return {}; }
+
+    std::suspend_never initial_suspend() const noexcept { return {}; }
+    std::suspend_never final_suspend() const noexcept { return {}; }
+
+    void return_void() const {}
+    void unhandled_exception() const { std::terminate(); }
+  };
+};
+
+/**
+ * @brief Tasks left to finish before the joining coroutine resumes
+ *
+ */
+struct Join_Counter {
+  size_t remaining = 0;
+  std::coroutine_handle<> joining;
+};
+
+/**
+ * @brief Awaits task and resumes joining coroutine if it was the last one
+ *
+ * @tparam T
+ * @param task Task
+ * @param counter Join counter
+ * @return Detached_Task
+ */
+template <typename T>
+Detached_Task join_one(Task<T> &task, Join_Counter &counter) {
+  co_await task.completion();
+
+  if (--counter.remaining == 0)
+    counter.joining.resume();
+}
+
+/**
+ * @brief Runs tasks concurrently, finishes once all of them have (results are
+ * checked in order, so the first exception thrown in task order propagates)
+ *
+ * @param tasks Tasks
+ * @return Task<bool> (whether every task succeeded)
+ */
+inline Task<bool> when_all(std::vector<Task<bool>> tasks) {
+  struct Join_Awaiter {
+    std::vector<Task<bool>> &tasks;
+    Join_Counter counter;
+
+    bool await_ready() const noexcept { return tasks.empty(); }
+
+    bool await_suspend(std::coroutine_handle<> joining) {
+      counter = {tasks.size() + 1, joining}; // Stays above 0 while starting
+
+      for (auto &task : tasks)
+        join_one(task, counter);
+
+      return --counter.remaining != 0;
+    }
+
+    void await_resume() const noexcept {}
+  };
+
+  co_await Join_Awaiter{tasks, {}};
+
+  bool success = true;
+
+  for (auto &task : tasks)
+    success = task.result() && success;
+
+  co_return success;
+}
+
+/**
+ * @brief Runs tasks concurrently, finishes once all of them have
+ *
+ * @tparam Tasks
+ * @param first First task
+ * @param rest Other tasks
+ * @return Task<bool> (whether every task succeeded)
+ */
+template <typename... Tasks>
+Task<bool> when_all(Task<bool> first, Tasks... rest) {
+  std::vector<Task<bool>> tasks;
+  tasks.reserve(1 + sizeof...(rest));
+  tasks.push_back(std::move(first));
+  (tasks.push_back(std::move(rest)), ...);
+
+  return when_all(std::move(tasks));
+}
\ No newline at end of file
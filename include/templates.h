@@ -0,0 +1,373 @@
+/**
+ * @file templates.h
+ * @brief Built-in file templates, parsed and validated at compile time
+ * @version 0.1
+ * @date 2025-03-30
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+
+#include "emitter.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace templates {
+/**
+ * @brief String literal usable as a template argument
+ *
+ * @tparam N Size of literal (including null terminator)
+ */
+template <size_t N> struct Fixed_String {
+  char data[N]{};
+
+  consteval Fixed_String(const char (&str)[N]) { std::copy_n(str, N, data); }
+
+  constexpr std::string_view view() const { return {data, N - 1}; }
+};
+
+constexpr std::string_view slot_open = "{{";
+constexpr std::string_view slot_close = "}}";
+constexpr size_t no_slot = SIZE_MAX;
+
+/**
+ * @brief Static text or a reference to a slot value
+ *
+ */
+struct Part {
+  std::string_view text;
+  size_t slot = no_slot;
+};
+
+/**
+ * @brief Compiled template, rendering only appends fragments (static parts
+ * and slot values) to an emitter
+ *
+ * @tparam part_count Number of parts
+ * @tparam slot_count Number of declared slots
+ */
+template <size_t part_count, size_t slot_count> struct Template {
+  std::array<Part, part_count> parts;
+  size_t static_length = 0; // Length of output without slot values
+
+  /**
+   * @brief Renders template into emitter (values are given in the order the
+   * slots were declared, a missing value fails to compile)
+   *
+   * @param out Emitter
+   * @param values Slot values
+   */
+  template <typename... Values>
+    requires(sizeof...(Values) == slot_count)
+  void render(Emitter &out, const Values &...values) const {
+    const std::array<std::string_view, slot_count> slot_values{
+        std::string_view(values)...};
+
+    out.reserve(part_count);
+
+    for (const auto &part : parts)
+      out.append(part.slot == no_slot ? part.text : slot_values[part.slot]);
+  }
+};
+
+/**
+ * @brief Finds token in text (unlike std::string_view::find, comparing
+ * characters one by one stays a constant expression on template argument
+ * strings when building with -fsanitize=undefined)
+ *
+ * @param text Text
+ * @param token Token to find
+ * @param pos Position to start at
+ * @return size_t (size of text if token was not found)
+ */
+consteval size_t find_token(std::string_view text, std::string_view token,
+                            size_t pos) {
+  for (; pos + token.size() <= text.size(); pos++) {
+    size_t i = 0;
+
+    while (i < token.size() && text[pos + i] == token[i])
+      i++;
+
+    if (i == token.size())
+      return pos;
+  }
+
+  return text.size();
+}
+
+/**
+ * @brief Checks if two strings are equal (see find_token)
+ *
+ * @param s1
+ * @param s2
+ * @return true
+ * @return false
+ */
+consteval bool equal(std::string_view s1, std::string_view s2) {
+  if (s1.size() != s2.size())
+    return false;
+
+  for (size_t i = 0; i < s1.size(); i++)
+    if (s1[i] != s2[i])
+      return false;
+
+  return true;
+}
+
+/**
+ * @brief Counts parts in template text
+ *
+ * @param text Template text
+ * @return size_t
+ */
+consteval size_t count_parts(std::string_view text) {
+  size_t count = 0;
+
+  for (size_t pos = 0; pos < text.size();) {
+    const size_t start = find_token(text, slot_open, pos);
+
+    if (start > pos)
+      count++;
+
+    if (start == text.size())
+      break;
+
+    const size_t end = find_token(text, slot_close, start);
+
+    if (end == text.size())
+      throw "template placeholder is not closed";
+
+    count++;
+    pos = end + slot_close.size();
+  }
+
+  return count;
+}
+
+/**
+ * @brief Compiles template text into parts, every {{placeholder}} must be a
+ * declared slot and every declared slot must be used (otherwise the build
+ * fails)
+ *
+ * @tparam text Template text
+ * @tparam slots Slot names
+ * @return Template
+ */
+template <Fixed_String text, Fixed_String... slots> consteval auto compile() {
+  constexpr std::string_view source = text.view();
+  constexpr std::array<std::string_view, sizeof...(slots)> names{
+      slots.view()...};
+
+  Template<count_parts(source), sizeof...(slots)> result{};
+  std::array<bool, sizeof...(slots)> used{};
+  size_t i = 0;
+
+  for (size_t pos = 0; pos < source.size();) {
+    const size_t start = find_token(source, slot_open, pos);
+
+    if (start > pos) {
+      result.parts[i++] = {source.substr(pos, start - pos)};
+      result.static_length += start - pos;
+    }
+
+    if (start == source.size())
+      break;
+
+    const size_t end = find_token(source, slot_close, start);
+    const std::string_view name = source.substr(
+        start + slot_open.size(), end - start - slot_open.size());
+    size_t slot = 0;
+
+    while (slot < names.size() && !equal(names[slot], name))
+      slot++;
+
+    if (slot == names.size())
+      throw "template placeholder is not a declared slot";
+
+    used[slot] = true;
+    result.parts[i++] = {{}, slot};
+    pos = end + slot_close.size();
+  }
+
+  for (const bool slot_used : used)
+    if (!slot_used)
+      throw "template slot is declared but never used";
+
+  return result;
+}
+
+/* Templates appended to file pairs (every line starts with a newline) */
+
+inline constexpr auto class_header = compile<"\nclass {{name}} {"
+                                             "\nprivate:"
+                                             "\n"
+                                             "\npublic:"
+                                             "\n\t{{name}}();"
+                                             "\n\t~{{name}}();"
+                                             "\n};",
+                                             "name">();
+
+inline constexpr auto class_source = compile<"\n{{name}}::{{name}}() {}"
+                                             "\n{{name}}::~{{name}}() {}",
+                                             "name">();
+
+inline constexpr auto derived_class_header =
+    compile<"\n#include \"{{include}}\""
+            "\n"
+            "\nclass {{name}}: {{inheritance}} {{parent}} {"
+            "\nprivate:"
+            "\n"
+            "\npublic:"
+            "\n\t{{name}}();"
+            "\n\t~{{name}}();"
+            "\n};",
+            "include", "name", "inheritance", "parent">();
+
+inline constexpr auto singleton_header =
+    compile<"\nclass {{name}} {"
+            "\nprivate:"
+            "\n\t{{name}}();"
+            "\n"
+            "\npublic:"
+            "\n\t{{name}}(const {{name}}& obj) = delete;"
+            "\n"
+            "\n\tstatic {{name}}& get();"
+            "\n};",
+            "name">();
+
+inline constexpr auto singleton_source =
+    compile<"\n{{name}}& {{name}}::get() {"
+            "\n\tstatic {{name}} obj;"
+            "\n\treturn obj;"
+            "\n}",
+            "name">();
+
+inline constexpr auto interface_header = compile<"\nclass {{name}} {"
+                                                 "\nprivate:"
+                                                 "\n"
+                                                 "\npublic:",
+                                                 "name">();
+
+inline constexpr auto interface_method =
+    compile<"\n\tvirtual void {{method}}() = 0;", "method">();
+
+inline constexpr auto interface_footer = compile<"\n};">();
+
+inline constexpr auto typedef_struct_header =
+    compile<"\ntypedef struct {"
+            "\n\t"
+            "\n} {{name}};"
+            "\n"
+            "\n{{name}} *create_{{file_name}}();",
+            "name", "file_name">();
+
+inline constexpr auto typedef_struct_source =
+    compile<"\n{{name}} *create_{{file_name}}() {"
+            "\n\t"
+            "\n}",
+            "name", "file_name">();
+
+inline constexpr auto struct_header =
+    compile<"\nstruct {{name}} {"
+            "\n"
+            "\n}"
+            "\n"
+            "\nstruct {{name}} *create_{{file_name}}();",
+            "name", "file_name">();
+
+inline constexpr auto struct_source =
+    compile<"\nstruct {{name}} *create_{{file_name}}() {"
+            "\n"
+            "\n}",
+            "name", "file_name">();
+
+/* Templates for new files (every line ends with a newline) */
+
+inline constexpr auto pair_header = compile<"#pragma once\n">();
+
+inline constexpr auto pair_source =
+    compile<"#include \"{{include}}{{extension}}\"\n", "include",
+            "extension">();
+
+inline constexpr auto cmake_lists = compile<
+    "cmake_minimum_required(VERSION {{cmake_version}})\n"
+    "\n"
+    "project(\n"
+    "\t{{name}}\n"
+    "\tLANGUAGES {{cmake_lang}}\n"
+    ")\n"
+    "\n"
+    "set(CMAKE_{{cmake_lang}}_STANDARD {{lang_version}})\n"
+    "set(SOURCE_DIR ${CMAKE_CURRENT_SOURCE_DIR}/src)\n"
+    "\n"
+    "file(GLOB_RECURSE SOURCES \"${SOURCE_DIR}/*.{{extension}}\")\n"
+    "\n"
+    "add_executable(\n"
+    "\t${PROJECT_NAME}\n"
+    "\t${SOURCES}\n"
+    ")\n"
+    "\n"
+    "target_include_directories(\n"
+    "\t${PROJECT_NAME} PRIVATE\n"
+    "\t${CMAKE_CURRENT_SOURCE_DIR}/include\n"
+    ")\n"
+    "\n"
+    "target_link_libraries(\n"
+    "\t${PROJECT_NAME} PRIVATE\n"
+    ")\n"
+    "\n"
+    "install(TARGETS ${PROJECT_NAME} DESTINATION /usr/local/bin)\n",
+    "cmake_version", "name", "cmake_lang", "lang_version", "extension">();
+
+inline constexpr auto workspace_cmake_lists =
+    compile<"cmake_minimum_required(VERSION {{cmake_version}})\n"
+            "\n"
+            "project(\n"
+            "\t{{name}}\n"
+            "\tLANGUAGES {{cmake_lang}}\n"
+            ")\n"
+            "\n",
+            "cmake_version", "name", "cmake_lang">();
+
+inline constexpr auto workspace_member =
+    compile<"add_subdirectory({{path}})\n", "path">();
+
+inline constexpr auto gitignore = compile<"# CMake artifacts\n"
+                                          "build\n"
+                                          "CMakeFiles/\n"
+                                          "CMakeCache.txt\n"
+                                          "CMakeScripts/\n"
+                                          "cmake_install.cmake\n"
+                                          "Makefile\n"
+                                          "\n"
+                                          "# Testing\n"
+                                          "tests\n"
+                                          "\n"
+                                          "# Others\n"
+                                          ".exe\n"
+                                          ".vscode/\n"
+                                          ".DS_Store\n"
+                                          ".cpm/\n">();
+
+inline constexpr auto readme = compile<"# {{name}}\n", "name">();
+
+inline constexpr auto cpp_main =
+    compile<"#include <iostream>\n"
+            "\n"
+            "int main(int argc, char *argv[]) {\n"
+            "\tstd::cout << \"Hello World!\" << std::endl;\n"
+            "\treturn 0;\n"
+            "}\n">();
+
+inline constexpr auto c_main = compile<"#include <stdio.h>\n"
+                                       "\n"
+                                       "int main(int argc, char *argv[]) {\n"
+                                       "\tprintf(\"Hello World!\\n\");\n"
+                                       "\treturn 0;\n"
+                                       "}\n">();
+} // namespace templates
\ No newline at end of file
@@ -0,0 +1,19 @@
+/**
+ * @file toolchain.h
+ * @brief Outlines toolchain.cpp
+ * @version 0.1
+ * @date 2025-03-09
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+namespace toolchain {
+std::filesystem::path find_program(const std::string &name);
+
+std::string get_cmake_version();
+} // namespace toolchain
\ No newline at end of file
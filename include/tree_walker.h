@@ -0,0 +1,125 @@
+/**
+ * @file tree_walker.h
+ * @brief Outlines tree_walker.cpp
+ * @version 0.1
+ * @date 2025-06-12
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <ctime>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief How a tree is walked
+ *
+ */
+struct Walk_Options {
+  bool recursive = true;
+  bool folders = false;   // Report folders too (the walked one as "")
+  bool gitignore = false; // Skip what .gitignore files ignore
+  size_t threads = 0;     // 0 for every core
+};
+
+/**
+ * @brief File or folder found by a walk
+ *
+ */
+struct Walk_Entry {
+  std::string path; // Relative to walked folder
+  size_t depth = 0; // 0 for entries of the walked folder
+  bool folder = false;
+  timespec modified{}; // Of folders, read before they were listed
+};
+
+/**
+ * @brief Walks folder trees with getdents64 and openat on worker threads
+ * that each work through their own deque of folders and steal from the
+ * others' once it runs dry, entries are handed to the calling thread in
+ * batches while the walk goes on
+ *
+ * Folders directory::skipped_folder skips and symbolic links to folders are
+ * never entered, like every listing of cpm.
+ *
+ */
+class Tree_Walker {
+private:
+  /**
+   * @brief One .gitignore line
+   *
+   */
+  struct Ignore_Rule {
+    std::string base; // Folder of the .gitignore, relative to project root
+    std::string pattern;
+    bool negated = false;
+    bool folders_only = false;
+    bool anchored = false; // Matched against the path below base, not name
+  };
+
+  using Ignore_Rules = std::shared_ptr<const std::vector<Ignore_Rule>>;
+
+  /**
+   * @brief Folder waiting to be read
+   *
+   */
+  struct Folder {
+    std::string path; // Relative to walked folder ("" for itself)
+    size_t depth = 0;
+    Ignore_Rules rules;
+  };
+
+  /**
+   * @brief Folders of one worker, it takes from the back, thieves from the
+   * front
+   *
+   */
+  struct Worker_Queue {
+    std::mutex mutex;
+    std::deque<Folder> folders;
+  };
+
+  Walk_Options options;
+  int base = -1;      // Walked folder
+  std::string prefix; // Walked folder relative to project root ("" or "x/")
+  std::vector<std::unique_ptr<Worker_Queue>> queues;
+
+  std::mutex mutex;
+  std::condition_variable folders_ready, entries_ready;
+  std::vector<Walk_Entry> entries; // Waiting for the calling thread
+  std::atomic<size_t> queued = 0;  // Folders in queues
+  std::atomic<size_t> pending = 0; // Folders queued or being read
+  std::atomic<bool> stopped = false;
+
+  void read_folder(const Folder &folder, std::vector<Walk_Entry> &found,
+                   std::vector<Folder> &subfolders) const;
+
+  bool ignored(const Ignore_Rules &rules, std::string_view path,
+               std::string_view name, const bool &folder) const;
+
+  Ignore_Rules read_rules(int dirfd, const Ignore_Rules &inherited,
+                          std::string_view folder) const;
+
+  void push(size_t worker, std::vector<Folder> &subfolders);
+
+  bool take(size_t worker, Folder &folder);
+
+  void work(size_t worker);
+
+public:
+  Tree_Walker(const Walk_Options &_options = {});
+
+  bool walk(const std::filesystem::path &folder,
+            const std::function<bool(const Walk_Entry &)> &on_entry);
+};
@@ -0,0 +1,93 @@
+/**
+ * @file uring.h
+ * @brief Outlines uring.cpp
+ * @version 0.1
+ * @date 2025-04-20
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <sys/uio.h>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+constexpr unsigned default_uring_entries = 256;
+
+/**
+ * @brief Minimal io_uring (set up with raw syscalls, no liburing) that
+ * submits batches of directory creations, removals and linked open -> write
+ * -> close chains, unavailable when the kernel (or a seccomp filter) refuses
+ * it
+ *
+ */
+class Uring {
+public:
+  /**
+   * @brief File written by one linked chain
+   *
+   */
+  struct Write {
+    int dirfd;                  // Directory path is relative to (or AT_FDCWD)
+    const char *path;           // Null terminated
+    int flags;                  // open flags (without O_CLOEXEC)
+    std::span<const iovec> iov; // At most IOV_MAX entries, may be empty
+    size_t size;                // Total size of iov
+    int error = 0;              // errno of first failed step (0 if none)
+  };
+
+  /**
+   * @brief Directory or file handled by one entry
+   *
+   */
+  struct Entry {
+    int dirfd;        // Directory path is relative to (or AT_FDCWD)
+    const char *path; // Null terminated
+    int error = 0;    // errno (0 if it exists afterwards)
+  };
+
+private:
+  int ring_fd = -1;
+  unsigned entries = 0;
+  unsigned file_slots = 0; // Registered (direct) descriptors
+
+  void *ring = nullptr;
+  size_t ring_size = 0;
+  io_uring_sqe *sqes = nullptr;
+  size_t sqes_size = 0;
+
+  unsigned *sq_tail = nullptr, *sq_mask = nullptr, *sq_array = nullptr;
+  unsigned *cq_head = nullptr, *cq_tail = nullptr, *cq_mask = nullptr;
+  io_uring_cqe *cqes = nullptr;
+
+  unsigned queued = 0; // Prepared but not yet submitted
+
+  io_uring_sqe &next_sqe(uint8_t opcode, uint64_t user_data);
+
+  template <typename Callback> bool submit_and_wait(Callback on_complete);
+
+  bool submit_each(std::span<Entry> targets, uint8_t opcode, uint32_t mode,
+                   int ignored_error);
+
+  void close_ring();
+
+public:
+  Uring(unsigned _entries = default_uring_entries);
+  ~Uring();
+
+  Uring(const Uring &) = delete;
+  Uring &operator=(const Uring &) = delete;
+
+  bool available() const;
+
+  bool make_folders(std::span<Entry> folders);
+
+  bool remove_files(std::span<Entry> files);
+
+  bool write_files(std::span<Write> files);
+};
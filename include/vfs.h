@@ -0,0 +1,159 @@
+/**
+ * @file vfs.h
+ * @brief Outlines vfs.cpp
+ * @version 0.1
+ * @date 2025-05-04
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+
+#include "emitter.h"
+
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory_resource>
+#include <set>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Filesystem cpm operates on, every directory:: function, File and
+ * Plan go through the current one
+ *
+ */
+class Vfs {
+public:
+  virtual ~Vfs() = default;
+
+  static Vfs &current();
+
+  static void use(Vfs *vfs);
+
+  /**
+   * @brief Checks if operations reach the real filesystem (Plan can then use
+   * io_uring and directory handles directly)
+   *
+   * @return true
+   * @return false
+   */
+  virtual bool on_disk() const = 0;
+
+  virtual bool is_folder(const std::filesystem::path &path) = 0;
+
+  virtual bool exists(const std::filesystem::path &path) = 0;
+
+  virtual bool make_folders(const std::filesystem::path &path) = 0;
+
+  virtual bool read(const std::filesystem::path &path, std::string &out) = 0;
+
+  virtual bool write(const std::filesystem::path &path, const Emitter &content,
+                     const bool &append) = 0;
+
+  virtual bool replace(const std::filesystem::path &path,
+                       const Emitter &content) = 0;
+
+  virtual bool remove(const std::filesystem::path &path) = 0;
+
+  virtual bool same_contents(const std::filesystem::path &path,
+                             std::span<const std::string_view> fragments,
+                             size_t size) = 0;
+
+  virtual void
+  list(const std::filesystem::path &folder, const bool &recursive,
+       const std::function<void(std::string_view relative_path)> &on_file) = 0;
+};
+
+/**
+ * @brief Real filesystem, paths inside the project are resolved through the
+ * directory handles of directory::at
+ *
+ */
+class Posix_Vfs : public Vfs {
+public:
+  bool on_disk() const override;
+
+  bool is_folder(const std::filesystem::path &path) override;
+
+  bool exists(const std::filesystem::path &path) override;
+
+  bool make_folders(const std::filesystem::path &path) override;
+
+  bool read(const std::filesystem::path &path, std::string &out) override;
+
+  bool write(const std::filesystem::path &path, const Emitter &content,
+             const bool &append) override;
+
+  bool replace(const std::filesystem::path &path,
+               const Emitter &content) override;
+
+  bool remove(const std::filesystem::path &path) override;
+
+  bool same_contents(const std::filesystem::path &path,
+                     std::span<const std::string_view> fragments,
+                     size_t size) override;
+
+  void list(const std::filesystem::path &folder, const bool &recursive,
+            const std::function<void(std::string_view relative_path)>
+                &on_file) override;
+};
+
+/**
+ * @brief In-memory tree layered over another filesystem, reads fall through
+ * to the lower filesystem until a path is written or removed in memory
+ * (nothing ever reaches the lower filesystem, not thread-safe)
+ *
+ */
+class Memory_Vfs : public Vfs {
+private:
+  Vfs *lower; // nullptr for an empty tree
+
+  std::pmr::monotonic_buffer_resource arena;
+
+  /* Keys are absolute and normalized */
+  std::pmr::map<std::pmr::string, std::pmr::string, std::less<>> files;
+  std::pmr::set<std::pmr::string, std::less<>> folders;
+  std::pmr::set<std::pmr::string, std::less<>> removed; // Hide lower files
+
+  bool has_file(std::string_view key);
+
+  bool has_folder(std::string_view key);
+
+public:
+  Memory_Vfs(Vfs *_lower = nullptr);
+
+  bool on_disk() const override;
+
+  bool is_folder(const std::filesystem::path &path) override;
+
+  bool exists(const std::filesystem::path &path) override;
+
+  bool make_folders(const std::filesystem::path &path) override;
+
+  bool read(const std::filesystem::path &path, std::string &out) override;
+
+  bool write(const std::filesystem::path &path, const Emitter &content,
+             const bool &append) override;
+
+  bool replace(const std::filesystem::path &path,
+               const Emitter &content) override;
+
+  bool remove(const std::filesystem::path &path) override;
+
+  bool same_contents(const std::filesystem::path &path,
+                     std::span<const std::string_view> fragments,
+                     size_t size) override;
+
+  void list(const std::filesystem::path &folder, const bool &recursive,
+            const std::function<void(std::string_view relative_path)>
+                &on_file) override;
+
+  size_t file_count() const;
+
+  bool dump(const std::filesystem::path &root, Vfs &target) const;
+};
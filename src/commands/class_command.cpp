@@ -11,9 +11,11 @@
 #include "../../include/commands/fpair_command.h"
 
 #include "../../include/directory.h"
-#include "../../include/file.h"
+#include "../../include/emitter.h"
 #include "../../include/logger.h"
 #include "../../include/misc.h"
+#include "../../include/paths.h"
+#include "../../include/templates.h"
 
 #include <filesystem>
 
@@ -31,7 +33,7 @@ Class_Command::Class_Command() {}
  * @return uint8_t
  */
 uint8_t Class_Command::execute(const std::vector<std::string> &args,
-                               const std::vector<std::string> &flags) const {
+                               const Flags &flags) const {
   if (directory::get_extension() == ".c") {
     logger.error("C programming language does not support classes");
     return 1;
@@ -40,7 +42,7 @@ uint8_t Class_Command::execute(const std::vector<std::string> &args,
   /* Create file pairs */
   std::vector<std::string> file_pair_args;
 
-  if (!misc::vector_contains(flags, "interface")) {
+  if (!flags.has(flag("interface"))) {
     file_pair_args = args;
     file_pair_args.insert(file_pair_args.begin(), "create");
   } else {
@@ -50,16 +52,23 @@ uint8_t Class_Command::execute(const std::vector<std::string> &args,
     };
   }
 
+  Flags file_pair_flags(Fpair_Command::flag_schema);
+
+  if (flags.has(flag("hpp")))
+    file_pair_flags.set(Fpair_Command::flag("hpp"));
+
   Fpair_Command fpair_command;
-  const uint8_t result = fpair_command.execute(file_pair_args, flags);
+  fpair_command.set_memory_resource(memory);
+  fpair_command.set_plan(plan);
+  const uint8_t result =
+      fpair_command.execute(file_pair_args, file_pair_flags);
 
   if (result != 0)
     return result;
 
   /* Open files */
-  std::string prefix_a, class_name;
+  std::string class_name;
   bool status = false;
-  std::vector<std::string> split_arg;
 
   for (const auto &arg : args) {
     std::filesystem::path _arg(
@@ -67,150 +76,81 @@ uint8_t Class_Command::execute(const std::vector<std::string> &args,
     class_name = std::filesystem::absolute(_arg).filename().string();
     misc::auto_capitalize(class_name);
 
-    /* Write to files */
-    prefix_a = class_name + "::";
-
-    File header(directory::get_structured_header_path(
-        arg, misc::vector_contains(flags, "hpp"))),
-        source(directory::get_structured_source_path(arg));
-
-    if (misc::vector_contains(flags, "singleton")) {
-      header.write({
-          "class " + class_name + " {",
-          "private:",
-          "\t" + class_name + "();",
-          "",
-          "public:",
-          "\t" + class_name + "(const " + class_name + "& obj) = delete;",
-          "",
-          "\tstatic " + class_name + "& get();",
-          "};",
-      });
-
-      source.write({
-          class_name + "& " + prefix_a + "get() {",
-          "\tstatic " + class_name + " obj;",
-          "\treturn obj;",
-          "}",
-      });
-    } else if (misc::vector_contains(flags, "interface")) {
-      header.write({
-          "class " + class_name + " {",
-          "private:",
-          "",
-          "public:",
-      });
+    /* Write to files (appended to what fpair planned) */
+    const std::filesystem::path header_path(
+        directory::get_structured_header_path(arg, flags.has(flag("hpp")))),
+        source_path(directory::get_structured_source_path(arg));
+    const std::string_view name = plan->keep(class_name);
+
+    if (flags.has(flag("singleton"))) {
+      templates::singleton_header.render(plan->append(header_path), name);
+      templates::singleton_source.render(plan->append(source_path), name);
+    } else if (flags.has(flag("interface"))) {
+      Emitter &header_out = plan->append(header_path);
+      templates::interface_header.render(header_out, name);
 
       /* For interfaces, all arguments after first are treated as virtual
        * functions */
-      for (const auto &arg :
-           misc::sub_vector<std::string>(args, 1, args.size() - 1))
-        header.write({"\tvirtual void " + arg + "() = 0;"});
+      for (size_t i = 1; i < args.size(); i++)
+        templates::interface_method.render(header_out, plan->keep(args[i]));
 
-      header.write({
-          "};",
-      });
+      templates::interface_footer.render(header_out);
 
       /* Source file isn't required */
-      source.remove();
+      plan->remove(source_path);
 
       return 0;
-    } else if (flags.size() > 0 && flags[0][0] == 'p') { // inheritance
+    } else if (flags.has(flag("parent"))) { // inheritance
       // Set '_arg' to path of parent header file
-      _arg = misc::get_flag_value(flags[0]);
+      _arg = flags.value(flag("parent"));
       const std::filesystem::path header_p_path(
-          std::filesystem::absolute(directory::get_structured_header_path(
-              _arg, !directory::has_file(
+          paths::absolute(directory::get_structured_header_path(
+              _arg, !plan->exists(
                         directory::get_structured_header_path(_arg)))));
 
-      if (!directory::has_file(header_p_path)) {
+      if (!plan->exists(header_p_path)) {
         logger.error_q("does not exist", header_p_path);
         return 1;
       }
 
-      File header_p(header_p_path);
-
       /* Switch 'private' to 'protected' if 'protected' doesn't already
-       * exist inside parent class */
-      if (!status && !header_p.exists("protected")) {
-        header_p.replace_first_with("private", "protected");
+       * exist inside parent class (checked on its planned contents) */
+      if (!status &&
+          !misc::has_token(plan->contents(header_p_path), "protected")) {
+        plan->patch(header_p_path, "private", "protected");
         status = true;
       }
 
       /* Get parent class name */
-      prefix_a = _arg.filename().string();
-      misc::auto_capitalize(prefix_a);
+      std::string parent_name = _arg.filename().string();
+      misc::auto_capitalize(parent_name);
 
       /* Get inherit mode (public, protected, private) */
-      std::string inherit_mode = "public ";
+      std::string_view inherit_mode = "public";
 
-      if (misc::vector_contains(flags, "protected"))
-        inherit_mode = "protected ";
-      else if (misc::vector_contains(flags, "private"))
-        inherit_mode = "private ";
+      if (flags.has(flag("protected")))
+        inherit_mode = "protected";
+      else if (flags.has(flag("private")))
+        inherit_mode = "private";
 
       /* Auto relative path detection (between parent header and child
        * header)
        */
       std::string include_path = "";
-      misc::set_relative_path(include_path, header.get_path(),
-                              header_p.get_path());
+      misc::set_relative_path(include_path,
+                              paths::absolute(header_path),
+                              header_p_path);
 
       /* Write to files */
-      header.write({
-          "#include \"" + include_path + "\"",
-          "",
-          "class " + class_name + ": " + inherit_mode + prefix_a + " {",
-          "private:",
-          "",
-          "public:",
-          "\t" + class_name + "();",
-          "\t~" + class_name + "();",
-          "};",
-      });
-
-      prefix_a = class_name + "::";
-
-      source.write({
-          prefix_a + class_name + "() {}",
-          prefix_a + "~" + class_name + "() {}",
-      });
+      templates::derived_class_header.render(
+          plan->append(header_path), plan->keep(include_path), name,
+          inherit_mode, plan->keep(parent_name));
+      templates::class_source.render(plan->append(source_path), name);
     } else {
-      header.write({
-          "class " + class_name + " {",
-          "private:",
-          "",
-          "public:",
-          "\t" + class_name + "();",
-          "\t~" + class_name + "();",
-          "};",
-      });
-
-      source.write({
-          prefix_a + class_name + "() {}",
-          prefix_a + "~" + class_name + "() {}",
-      });
+      templates::class_header.render(plan->append(header_path), name);
+      templates::class_source.render(plan->append(source_path), name);
     }
   }
 
   return 0;
-}
-
-std::string Class_Command::get_description() const {
-  return "Creates a class-based header-source file pair with many options "
-         "(overrides existing headdr-source file pairs with same names)";
-}
-
-std::string Class_Command::get_arguments() const {
-  return "[names] names of files that will contain classes or names of pure "
-         "virtual functions (depending on flags)";
-}
-
-std::string Class_Command::get_flags() const {
-  return "-p=[parent file name] specify a parent file to inhert "
-         "from\t--private use private inheritance\t--protected use protected "
-         "inheritance\t--singleton create singleton\t--interface create "
-         "interface";
-}
-
-uint16_t Class_Command::get_min_args() const { return 1; }
\ No newline at end of file
+}
\ No newline at end of file
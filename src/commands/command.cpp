@@ -10,4 +10,28 @@
 #include "../../include/commands/command.h"
 
 Logger &Command::logger = Logger::get();
-Data_Manager &Command::data_manager = Data_Manager::get();
\ No newline at end of file
+Data_Manager &Command::data_manager = Data_Manager::get();
+
+/**
+ * @brief Sets memory resource used for short-lived allocations while command
+ * executes
+ *
+ * @param _memory Memory resource
+ */
+void Command::set_memory_resource(std::pmr::memory_resource *_memory) {
+  memory = _memory;
+}
+
+/**
+ * @brief Sets plan filesystem operations are recorded into
+ *
+ * @param _plan Plan
+ */
+void Command::set_plan(Plan *_plan) { plan = _plan; }
+
+/**
+ * @brief Sets if plan is only printed instead of executed
+ *
+ * @param _dry_run Run is a dry run
+ */
+void Command::set_dry_run(const bool &_dry_run) { dry_run = _dry_run; }
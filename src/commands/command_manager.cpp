@@ -8,71 +8,214 @@
  *
  */
 #include "../../include/commands/command_manager.h"
+#include "../../include/commands/class_command.h"
+#include "../../include/commands/completions_command.h"
+#include "../../include/commands/config_command.h"
+#include "../../include/commands/find_command.h"
+#include "../../include/commands/fpair_command.h"
+#include "../../include/commands/init_command.h"
+#include "../../include/commands/stats_command.h"
+#include "../../include/commands/struct_command.h"
+#include "../../include/commands/version_command.h"
+#include "../../include/commands/watch_command.h"
 #include "../../include/logger.h"
-#include "../../include/misc.h"
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <iostream>
+#include <memory_resource>
 
 Logger &logger = Logger::get();
 
+namespace {
+/* Initial (stack) size of per-command arena, grows on the heap if exceeded */
+constexpr size_t arena_size = 16 * 1024;
+
 /**
- * @brief Registers command
+ * @brief Constructs command of type T
  *
- * @param name
- * @param command
+ * @tparam T Command type
+ * @return std::unique_ptr<Command>
  */
-void Command_Manager::register_command(const std::string &name,
-                                       std::unique_ptr<Command> command) {
-  commands[name] = std::move(command);
+template <typename T> std::unique_ptr<Command> create_command() {
+  return std::make_unique<T>();
 }
 
 /**
- * @brief Checks if command has been registered
+ * @brief Builds command table entry from static command information
  *
- * @param name
- * @return true
- * @return false
+ * @tparam T Command type
+ * @return Command_Entry
  */
-bool Command_Manager::exists(const std::string &name) const {
-  if (commands.find(name) == commands.end())
-    return false;
+template <typename T> constexpr Command_Entry make_entry() {
+  static_assert(T::flag_schema.size() <= max_flags,
+                "flag schema exceeds max_flags");
 
-  return true;
+  return {T::name,      T::min_args,    T::description,
+          T::arguments, T::flag_schema, T::config_keys,
+          &create_command<T>};
 }
 
+/* Sorted by name, looked up with a binary search */
+constexpr std::array commands = {
+    make_entry<Class_Command>(),   make_entry<Completions_Command>(),
+    make_entry<Config_Command>(),  make_entry<Find_Command>(),
+    make_entry<Fpair_Command>(),   make_entry<Init_Command>(),
+    make_entry<Stats_Command>(),   make_entry<Struct_Command>(),
+    make_entry<Version_Command>(), make_entry<Watch_Command>(),
+};
+
+static_assert(std::ranges::is_sorted(commands, {}, &Command_Entry::name),
+              "command table must be sorted by name");
+
 /**
- * @brief Executes command
+ * @brief Builds tab-separated description of flags in schema
  *
- * @param name
- * @param args
- * @param flags
- * @return uint8_t
+ * @param schema Flag schema
+ * @return std::string
  */
-uint8_t Command_Manager::execute(const std::string &name,
-                                 const std::vector<std::string> &args,
-                                 const std::vector<std::string> &flags) const {
-  auto cmd = commands.find(name);
-
-  if (cmd == commands.end()) {
-    logger.error_q("is not a registered command, try using cpm --help for "
-                   "command information",
-                   name);
-    return 1;
+constexpr std::string
+build_flag_description(std::span<const Flag_Spec> schema) {
+  if (schema.empty())
+    return "None";
+
+  std::string description;
+
+  for (const auto &spec : schema) {
+    if (!description.empty())
+      description += "\t";
+
+    if (spec.alias != '\0') {
+      description += '-';
+      description += spec.alias;
+      description += ", ";
+    }
+
+    description += "--";
+    description += spec.name;
+    description += (spec.type == Flag_Type::value) ? "=" : " ";
+    description += spec.description;
+  }
+
+  return description;
+}
+
+/**
+ * @brief Builds the command listing shown by cpm --help
+ *
+ * @return std::string
+ */
+constexpr std::string build_help_listing() {
+  std::string listing;
+
+  for (const auto &entry : commands) {
+    std::string min_args;
+    uint16_t n = entry.min_args;
+
+    do {
+      min_args.insert(min_args.begin(), static_cast<char>('0' + n % 10));
+      n /= 10;
+    } while (n > 0);
+
+    listing += entry.name;
+    listing += " command:\n\targuments: ";
+    listing += entry.arguments;
+    listing += "\n\tflags: ";
+    listing += build_flag_description(entry.flag_schema);
+    listing += "\n\tminimum arguments: ";
+    listing += min_args;
+    listing += "\n\n";
+  }
+
+  return listing;
+}
+
+constexpr auto help_listing_storage = [] {
+  std::array<char, build_help_listing().size()> storage{};
+  std::ranges::copy(build_help_listing(), storage.begin());
+  return storage;
+}();
+
+constexpr std::string_view help_listing(help_listing_storage.data(),
+                                        help_listing_storage.size());
+
+/**
+ * @brief Prints help text, placing every tab-separated item on its own line
+ *
+ * @param text Help text
+ */
+void print_items(std::string_view text) {
+  size_t pos;
+
+  while ((pos = text.find('\t')) != std::string_view::npos) {
+    std::cout << text.substr(0, pos) << "\n\t";
+    text.remove_prefix(pos + 1);
   }
 
-  return cmd->second->execute(args, flags);
+  std::cout << text;
 }
+} // namespace
 
 /**
- * @brief Gets minimum number of arguments for command
+ * @brief Finds command in command table
  *
  * @param name Command name
- * @return uint16_t
+ * @return const Command_Entry* (nullptr if command does not exist)
  */
-uint16_t Command_Manager::get_min_args(const std::string &name) const {
-  auto cmd = commands.find(name);
+const Command_Entry *Command_Manager::find(std::string_view name) {
+  const auto cmd =
+      std::ranges::lower_bound(commands, name, {}, &Command_Entry::name);
+
+  if (cmd == commands.end() || cmd->name != name)
+    return nullptr;
 
-  return cmd->second->get_min_args();
+  return &*cmd;
+}
+
+/**
+ * @brief Gets command table (sorted by name)
+ *
+ * @return std::span<const Command_Entry>
+ */
+std::span<const Command_Entry> Command_Manager::entries() { return commands; }
+
+/**
+ * @brief Constructs and executes command, giving it an arena that is released
+ * in one go once it returns, then executes (or prints) the filesystem
+ * operations it planned
+ *
+ * @param entry
+ * @param args
+ * @param flags
+ * @param dry_run Print plan instead of executing it
+ * @return uint8_t
+ */
+uint8_t Command_Manager::execute(const Command_Entry &entry,
+                                 const std::vector<std::string> &args,
+                                 const Flags &flags,
+                                 const bool &dry_run) const {
+  std::array<std::byte, arena_size> buffer;
+  std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size());
+  Plan plan(&arena);
+
+  const std::unique_ptr<Command> command = entry.create();
+  command->set_memory_resource(&arena);
+  command->set_plan(&plan);
+  command->set_dry_run(dry_run);
+
+  const uint8_t result = command->execute(args, flags);
+
+  /* Failed commands leave the filesystem untouched */
+  if (result != 0)
+    return result;
+
+  if (dry_run) {
+    plan.print();
+    return 0;
+  }
+
+  return plan.execute() ? 0 : 1;
 }
 
 /**
@@ -100,42 +243,36 @@ uint8_t Command_Manager::help_menu(const std::vector<std::string> &args) const {
               << logger.colors["reset"];
 
     logger.custom("https://github.com/vkeshav300/cpm", "github page", "theme");
-    std::cout << "\n" << logger.colors["theme"];
-    for (const auto &[name, cmd] : commands)
-      std::cout << name << " command:\n"
-                << "\targuments: " << cmd->get_arguments()
-                << "\n\tflags: " << cmd->get_flags()
-                << "\n\tminimum arguments: "
-                << std::to_string(cmd->get_min_args()) << "\n\n";
-
-    std::cout << logger.colors["reset"];
+    std::cout << "\n"
+              << logger.colors["theme"] << help_listing
+              << logger.colors["reset"];
   } else {
-    auto cmd = commands.find(args[0]);
+    const Command_Entry *cmd = find(args[0]);
 
-    if (cmd == commands.end()) {
+    if (!cmd) {
       logger.error_q(
           "does not have any registered information, try using cpm --help",
           args[0]);
       return 1;
     }
 
-    std::cout << logger.colors["theme"] << cmd->first << " command:\n"
-              << "description: " << cmd->second->get_description()
-              << "\narguments:\n\t";
+    std::cout << logger.colors["theme"] << cmd->name << " command:\n"
+              << "description: " << cmd->description << "\narguments:\n\t";
+    print_items(cmd->arguments);
 
-    std::string cout_str(cmd->second->get_arguments());
-    misc::replace_string_instances(cout_str, "\t", "\n\t");
-    std::cout << cout_str;
+    std::cout << "\n\nflags:\n\t";
+    print_items(build_flag_description(cmd->flag_schema));
 
-    cout_str = cmd->second->get_flags();
-    misc::replace_string_instances(cout_str, "\t", "\n\t");
-    std::cout << "\n\nflags:\n\t" << cout_str << "\n\nminimum arguments: "
-              << std::to_string(cmd->second->get_min_args()) << "\n\n"
+    std::cout << "\n\nminimum arguments: " << cmd->min_args << "\n\n"
               << logger.colors["reset"];
   }
 
   std::cout << "universal flags (work with any command they apply to):\n"
-            << "\t--hpp use .hpp header files instead of .h header files\n"
+            << "\t--help display help menu for command\n"
+            << "\t--dry-run print planned filesystem operations instead of "
+               "performing them\n"
+            << "\t--in-memory[=directory] keep files in memory instead of "
+               "writing them (dumped to directory if given)\n"
             << "\n";
 
   return 0;
@@ -0,0 +1,491 @@
+/**
+ * @file completions_command.cpp
+ * @brief Adds functionality to completions command
+ * @version 0.1
+ * @date 2025-05-18
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#include "../../include/commands/completions_command.h"
+#include "../../include/commands/command_manager.h"
+
+#include "../../include/emitter.h"
+#include "../../include/paths.h"
+
+#include <array>
+#include <filesystem>
+
+namespace {
+/**
+ * @brief Words completed at the first argument of a command
+ *
+ */
+struct Subcommands {
+  std::string_view command;
+  std::string_view words; // Separated by spaces
+};
+
+constexpr std::array<Subcommands, 4> subcommands = {{
+    {"completions", "bash zsh fish"},
+    {"config", "set remove"},
+    {"fpair", "create remove"},
+    {"init", "c cpp"},
+}};
+
+/**
+ * @brief Place where the pair names of the completion cache are completed,
+ * either a value flag or every argument after a subcommand
+ *
+ */
+struct Pair_Completion {
+  std::string_view command;
+  std::string_view flag;       // Empty if completed after subcommand
+  std::string_view subcommand; // Empty if completed as flag value
+};
+
+constexpr std::array<Pair_Completion, 2> pair_completions = {{
+    {"class", "parent", ""},
+    {"fpair", "", "remove"},
+}};
+
+/* Flags main handles for every command */
+constexpr std::array<std::string_view, 3> universal_flags = {
+    "--help", "--dry-run", "--in-memory="};
+
+/* Folder of the cache, marks the project root the scripts walk up to (the
+ * cache is relative to it, not to the shell's working directory) */
+constexpr std::string_view cache_folder =
+    Completions_Command::cache_path.substr(
+        0, Completions_Command::cache_path.find('/'));
+
+/**
+ * @brief Gets script file name for shell (zsh autoloads _<command> files)
+ *
+ * @param shell Shell
+ * @return std::string_view (empty if shell is not supported)
+ */
+std::string_view script_name(std::string_view shell) {
+  if (shell == "bash")
+    return "cpm.bash";
+
+  if (shell == "zsh")
+    return "_cpm";
+
+  if (shell == "fish")
+    return "cpm.fish";
+
+  return {};
+}
+
+/**
+ * @brief Gets flags of command as typed on the command line (value flags end
+ * with '=')
+ *
+ * @param entry Command
+ * @return std::string (separated by spaces)
+ */
+std::string flag_words(const Command_Entry &entry) {
+  std::string words;
+
+  for (const auto &spec : entry.flag_schema) {
+    const std::string_view suffix = (spec.type == Flag_Type::value) ? "=" : "";
+
+    words += "--" + std::string(spec.name) + std::string(suffix) + " ";
+
+    if (spec.alias != '\0')
+      words += std::string("-") + spec.alias + std::string(suffix) + " ";
+  }
+
+  for (const auto &flag : universal_flags)
+    words += std::string(flag) + " ";
+
+  words.pop_back();
+  return words;
+}
+
+/**
+ * @brief Gets every command name
+ *
+ * @return std::string (separated by spaces)
+ */
+std::string command_words() {
+  std::string words;
+
+  for (const auto &entry : Command_Manager::entries())
+    words += std::string(entry.name) + " ";
+
+  return words + "--help";
+}
+
+/**
+ * @brief Quotes text for fish (inside single quotes only \ and ' are
+ * escaped)
+ *
+ * @param text Text
+ * @return std::string
+ */
+std::string fish_quoted(std::string_view text) {
+  std::string quoted = "'";
+
+  for (const char ch : text) {
+    if (ch == '\\' || ch == '\'')
+      quoted += '\\';
+
+    quoted += ch;
+  }
+
+  return quoted + "'";
+}
+
+/**
+ * @brief Builds bash completion script (registered with complete -F)
+ *
+ * @return std::string
+ */
+std::string bash_script() {
+  std::string script =
+      "# cpm completion script for bash (generated by cpm completions bash)\n"
+      "_cpm_pairs() {\n"
+      "  local LC_ALL=C dir=$PWD names low=0 high mid\n"
+      "\n"
+      "  # The cache belongs to the nearest project above the shell\n"
+      "  until [[ -d $dir/" +
+      std::string(cache_folder) +
+      " ]]; do\n"
+      "    [[ $dir ]] || return\n"
+      "    dir=${dir%/*}\n"
+      "  done\n"
+      "\n"
+      "  [[ -r $dir/" +
+      std::string(Completions_Command::cache_path) +
+      " ]] || return\n"
+      "  mapfile -t names < \"$dir/" +
+      std::string(Completions_Command::cache_path) +
+      "\"\n"
+      "  high=${#names[@]}\n"
+      "\n"
+      "  # The cache is sorted, so matches follow the first name >= prefix\n"
+      "  while ((low < high)); do\n"
+      "    mid=$(((low + high) / 2))\n"
+      "    if [[ ${names[mid]} < $1 ]]; then low=$((mid + 1)); else high=$mid; "
+      "fi\n"
+      "  done\n"
+      "\n"
+      "  while ((low < ${#names[@]})) && [[ ${names[low]} == \"$1\"* ]]; do\n"
+      "    COMPREPLY+=(\"${names[low++]}\")\n"
+      "  done\n"
+      "}\n"
+      "\n"
+      "_cpm() {\n"
+      "  local cur=${COMP_WORDS[COMP_CWORD]} prev=${COMP_WORDS[COMP_CWORD-1]}\n"
+      "  local cmd=${COMP_WORDS[1]} flag=\"\" flags=\"\"\n"
+      "  COMPREPLY=()\n"
+      "\n"
+      "  if ((COMP_CWORD == 1)); then\n"
+      "    COMPREPLY=($(compgen -W \"" +
+      command_words() +
+      "\" -- \"$cur\"))\n"
+      "    return\n"
+      "  fi\n"
+      "\n"
+      "  # --flag=value is split at '='\n"
+      "  if [[ $cur == \"=\" ]]; then\n"
+      "    flag=$prev cur=\"\"\n"
+      "  elif [[ $prev == \"=\" ]]; then\n"
+      "    flag=${COMP_WORDS[COMP_CWORD-2]}\n"
+      "  fi\n"
+      "\n"
+      "  if [[ -n $flag ]]; then\n"
+      "    case \"$cmd $flag\" in\n";
+
+  for (const auto &completion : pair_completions) {
+    if (completion.flag.empty())
+      continue;
+
+    const Command_Entry *entry = Command_Manager::find(completion.command);
+    std::string patterns = "\"" + std::string(completion.command) + " --" +
+                           std::string(completion.flag) + "\"";
+
+    for (const auto &spec : entry->flag_schema)
+      if (spec.name == completion.flag && spec.alias != '\0')
+        patterns += "|\"" + std::string(completion.command) + " -" +
+                    spec.alias + "\"";
+
+    script += "      " + patterns + ") _cpm_pairs \"$cur\" ;;\n";
+  }
+
+  script += "    esac\n"
+            "    return\n"
+            "  fi\n"
+            "\n"
+            "  case $cmd in\n";
+
+  for (const auto &entry : Command_Manager::entries())
+    script += "    " + std::string(entry.name) + ") flags=\"" +
+              flag_words(entry) + "\" ;;\n";
+
+  script += "  esac\n"
+            "\n"
+            "  if [[ $cur == -* ]]; then\n"
+            "    COMPREPLY=($(compgen -W \"$flags\" -- \"$cur\"))\n"
+            "    [[ ${COMPREPLY[0]} == *= ]] && compopt -o nospace\n"
+            "    return\n"
+            "  fi\n"
+            "\n"
+            "  if ((COMP_CWORD == 2)); then\n"
+            "    case $cmd in\n";
+
+  for (const auto &subcommand : subcommands)
+    script += "      " + std::string(subcommand.command) +
+              ") COMPREPLY=($(compgen -W \"" + std::string(subcommand.words) +
+              "\" -- \"$cur\")) ;;\n";
+
+  script += "    esac\n"
+            "    return\n"
+            "  fi\n"
+            "\n"
+            "  case \"$cmd ${COMP_WORDS[2]}\" in\n";
+
+  for (const auto &completion : pair_completions)
+    if (!completion.subcommand.empty())
+      script += "    \"" + std::string(completion.command) + " " +
+                std::string(completion.subcommand) +
+                "\") _cpm_pairs \"$cur\" ;;\n";
+
+  return script + "  esac\n"
+                  "}\n"
+                  "\n"
+                  "complete -F _cpm cpm\n";
+}
+
+/**
+ * @brief Builds zsh completion script (autoloaded from fpath as _cpm)
+ *
+ * @return std::string
+ */
+std::string zsh_script() {
+  std::string script =
+      "#compdef cpm\n"
+      "# cpm completion script for zsh (generated by cpm completions zsh)\n"
+      "_cpm_pairs() {\n"
+      "  local dir=$PWD\n"
+      "\n"
+      "  # The cache belongs to the nearest project above the shell\n"
+      "  until [[ -d $dir/" +
+      std::string(cache_folder) +
+      " ]]; do\n"
+      "    [[ -n $dir ]] || return\n"
+      "    dir=${dir%/*}\n"
+      "  done\n"
+      "\n"
+      "  [[ -r $dir/" +
+      std::string(Completions_Command::cache_path) +
+      " ]] && compadd -- ${(f)\"$(< \"$dir/" +
+      std::string(Completions_Command::cache_path) +
+      "\")\"}\n"
+      "}\n"
+      "\n"
+      "_cpm() {\n"
+      "  local cmd=${words[2]} cur=${words[CURRENT]} flags\n"
+      "\n"
+      "  if ((CURRENT == 2)); then\n"
+      "    compadd -- " +
+      command_words() +
+      "\n"
+      "    return\n"
+      "  fi\n"
+      "\n"
+      "  case \"$cmd $cur\" in\n";
+
+  for (const auto &completion : pair_completions) {
+    if (completion.flag.empty())
+      continue;
+
+    const Command_Entry *entry = Command_Manager::find(completion.command);
+    std::string patterns = "\"" + std::string(completion.command) + " --" +
+                           std::string(completion.flag) + "=\"*";
+
+    for (const auto &spec : entry->flag_schema)
+      if (spec.name == completion.flag && spec.alias != '\0')
+        patterns += "|\"" + std::string(completion.command) + " -" +
+                    spec.alias + "=\"*";
+
+    script += "    " + patterns + ")\n"
+              "      compset -P '*='\n"
+              "      _cpm_pairs\n"
+              "      return ;;\n";
+  }
+
+  script += "  esac\n"
+            "\n"
+            "  case $cmd in\n";
+
+  for (const auto &entry : Command_Manager::entries())
+    script += "    " + std::string(entry.name) + ") flags=(" +
+              flag_words(entry) + ") ;;\n";
+
+  script += "  esac\n"
+            "\n"
+            "  if [[ $cur == -* ]]; then\n"
+            "    compadd -- ${flags:#*=}\n"
+            "    compadd -S '' -- ${(M)flags:#*=}\n"
+            "    return\n"
+            "  fi\n"
+            "\n"
+            "  if ((CURRENT == 3)); then\n"
+            "    case $cmd in\n";
+
+  for (const auto &subcommand : subcommands)
+    script += "      " + std::string(subcommand.command) + ") compadd -- " +
+              std::string(subcommand.words) + " ;;\n";
+
+  script += "    esac\n"
+            "    return\n"
+            "  fi\n"
+            "\n"
+            "  case \"$cmd ${words[3]}\" in\n";
+
+  for (const auto &completion : pair_completions)
+    if (!completion.subcommand.empty())
+      script += "    \"" + std::string(completion.command) + " " +
+                std::string(completion.subcommand) + "\") _cpm_pairs ;;\n";
+
+  return script + "  esac\n"
+                  "}\n"
+                  "\n"
+                  "_cpm \"$@\"\n";
+}
+
+/**
+ * @brief Builds fish completion script (one complete rule per command, flag
+ * and subcommand)
+ *
+ * @return std::string
+ */
+std::string fish_script() {
+  std::string script =
+      "# cpm completion script for fish (generated by cpm completions fish)\n"
+      "function __cpm_pairs\n"
+      "    set -l dir $PWD\n"
+      "\n"
+      "    # The cache belongs to the nearest project above the shell\n"
+      "    while not test -d \"$dir/" +
+      std::string(cache_folder) +
+      "\"\n"
+      "        test -n \"$dir\"; or return\n"
+      "        set dir (string replace -r '/[^/]*$' '' -- \"$dir\")\n"
+      "    end\n"
+      "\n"
+      "    test -r \"$dir/" +
+      std::string(Completions_Command::cache_path) +
+      "\"; or return\n"
+      "    string match '*' < \"$dir/" +
+      std::string(Completions_Command::cache_path) +
+      "\"\n"
+      "end\n"
+      "\n"
+      "complete -c cpm -f\n"
+      "complete -c cpm -l help -d 'display help menu for command'\n"
+      "complete -c cpm -l dry-run -d 'print planned filesystem operations'\n"
+      "complete -c cpm -l in-memory -d 'keep files in memory'\n";
+
+  for (const auto &entry : Command_Manager::entries()) {
+    const std::string seen =
+        "'__fish_seen_subcommand_from " + std::string(entry.name) + "'";
+
+    script += "complete -c cpm -n __fish_use_subcommand -a " +
+              std::string(entry.name) + " -d " +
+              fish_quoted(entry.description) + "\n";
+
+    for (const auto &spec : entry.flag_schema) {
+      script += "complete -c cpm -n " + seen + " -l " + std::string(spec.name);
+
+      if (spec.alias != '\0')
+        script += std::string(" -s ") + spec.alias;
+
+      if (spec.type == Flag_Type::value)
+        script += " -r";
+
+      for (const auto &completion : pair_completions)
+        if (completion.command == entry.name && completion.flag == spec.name)
+          script += " -a '(__cpm_pairs)'";
+
+      script += " -d " + fish_quoted(spec.description) + "\n";
+    }
+  }
+
+  for (const auto &subcommand : subcommands)
+    script += "complete -c cpm -n '__fish_seen_subcommand_from " +
+              std::string(subcommand.command) +
+              "; and not __fish_seen_subcommand_from " +
+              std::string(subcommand.words) + "' -a '" +
+              std::string(subcommand.words) + "'\n";
+
+  for (const auto &completion : pair_completions)
+    if (!completion.subcommand.empty())
+      script += "complete -c cpm -n '__fish_seen_subcommand_from " +
+                std::string(completion.command) +
+                "; and __fish_seen_subcommand_from " +
+                std::string(completion.subcommand) + "' -a '(__cpm_pairs)'\n";
+
+  return script;
+}
+} // namespace
+
+/**
+ * @brief Construct a new Completions_Command object
+ *
+ */
+Completions_Command::Completions_Command() {}
+
+/**
+ * @brief Execute completions command (takes no flags)
+ *
+ * @param args
+ * @return uint8_t
+ */
+uint8_t Completions_Command::execute(const std::vector<std::string> &args,
+                                     const Flags &) const {
+  const std::string &shell = args[0];
+  const std::string_view file_name = script_name(shell);
+
+  if (file_name.empty()) {
+    logger.error_q("is not a supported shell (bash, zsh or fish)", shell);
+    return 1;
+  }
+
+  /* Script location */
+  std::filesystem::path script_path;
+
+  if (args.size() > 1)
+    script_path = args[1];
+  else if (const std::filesystem::path store = get_store_location();
+           !store.empty())
+    script_path = store / "completions" / file_name;
+  else {
+    logger.error("no home directory to write script to, pass a path");
+    return 1;
+  }
+
+  script_path = paths::absolute(script_path);
+
+  const std::string script = (shell == "bash")  ? bash_script()
+                             : (shell == "zsh") ? zsh_script()
+                                                : fish_script();
+
+  plan->mkdir(script_path.parent_path());
+  plan->write(script_path).append(plan->keep(script));
+
+  if (shell == "zsh")
+    logger.custom("add 'fpath=(" + script_path.parent_path().string() +
+                      " $fpath)' before compinit in ~/.zshrc",
+                  "completions", "theme");
+  else
+    logger.custom("add 'source " + script_path.string() + "' to " +
+                      ((shell == "bash") ? "~/.bashrc"
+                                         : "~/.config/fish/config.fish"),
+                  "completions", "theme");
+
+  return 0;
+}
@@ -0,0 +1,187 @@
+/**
+ * @file find_command.cpp
+ * @brief Adds functionality to find command
+ * @version 0.1
+ * @date 2025-06-10
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#include "../../include/commands/find_command.h"
+
+#include "../../include/search_index.h"
+#include "../../include/vfs.h"
+
+#include <algorithm>
+#include <functional>
+#include <optional>
+#include <regex>
+
+namespace {
+/**
+ * @brief Calls on_line for every line of text containing pattern
+ *
+ * @param text Text (folded if the search ignores case)
+ * @param pattern Text to find (folded like text)
+ * @param on_line Called with line number and offsets of line in text
+ */
+void find_text(std::string_view text, std::string_view pattern,
+               const std::function<void(size_t, size_t, size_t)> &on_line) {
+  size_t line_number = 1;
+  size_t counted = 0; // Line breaks before this offset are counted
+
+  for (size_t found = text.find(pattern); found < text.size();) {
+    const size_t start =
+        (found == 0) ? 0 : text.rfind('\n', found - 1) + 1; // npos + 1 is 0
+    const size_t end = std::min(text.find('\n', found), text.size());
+
+    line_number += std::count(text.begin() + counted, text.begin() + start,
+                              '\n');
+    counted = start;
+    on_line(line_number, start, end);
+
+    if (end == text.size())
+      break;
+
+    found = text.find(pattern, end + 1);
+  }
+}
+
+/**
+ * @brief Calls on_line for every line of text matching expression
+ *
+ * @param text Text
+ * @param expression Regular expression
+ * @param on_line Called with line number and offsets of line in text
+ */
+void find_regex(std::string_view text, const std::regex &expression,
+                const std::function<void(size_t, size_t, size_t)> &on_line) {
+  size_t line_number = 1;
+
+  for (size_t start = 0; start < text.size(); line_number++) {
+    const size_t end = std::min(text.find('\n', start), text.size());
+
+    if (std::regex_search(text.begin() + start, text.begin() + end,
+                          expression))
+      on_line(line_number, start, end);
+
+    start = end + 1;
+  }
+}
+} // namespace
+
+/**
+ * @brief Construct a new Find_Command object
+ *
+ */
+Find_Command::Find_Command() {}
+
+/**
+ * @brief Execute find command
+ *
+ * @param args
+ * @param flags
+ * @return uint8_t
+ */
+uint8_t Find_Command::execute(const std::vector<std::string> &args,
+                              const Flags &flags) const {
+  const std::string &pattern = args[0];
+  const bool regex = flags.has(flag("regex"));
+  const bool ignore_case = flags.has(flag("ignore-case"));
+  std::optional<std::regex> expression;
+
+  if (regex) {
+    const std::regex::flag_type syntax =
+        ignore_case ? std::regex::ECMAScript | std::regex::icase
+                    : std::regex::ECMAScript;
+
+    try {
+      expression.emplace(pattern, syntax);
+    } catch (const std::regex_error &error) {
+      logger.error_q("is not a valid regular expression (" +
+                         std::string(error.what()) + ")",
+                     pattern);
+      return 1;
+    }
+  }
+
+  /* Index (brought up to date unless the cached one is asked for, a dry run
+   * doesn't write it) */
+  search_index::Index index;
+  const bool loaded = index.load();
+
+  if (!loaded || !flags.has(flag("cached"))) {
+    const size_t changed = index.update();
+
+    if ((changed != 0 || !loaded) && !dry_run && !index.save())
+      logger.warn_q("could not be written, the index is built again next time",
+                    std::string(search_index::index_path));
+  }
+
+  std::vector<uint32_t> candidates =
+      index.candidates(search_index::required_trigrams(pattern, regex));
+
+  /* Changed files have newer ids, matches are printed by path */
+  std::ranges::sort(candidates, {}, [&](uint32_t id) -> const std::string & {
+    return index.files[id].path;
+  });
+
+  /* Matches, checked against the files themselves */
+  std::string folded_pattern = pattern;
+  std::ranges::transform(folded_pattern, folded_pattern.begin(),
+                         search_index::fold);
+
+  std::string text, folded;
+  size_t matches = 0, matched_files = 0;
+
+  for (const uint32_t id : candidates) {
+    const std::string &path = index.files[id].path;
+
+    if (!Vfs::current().read(path, text))
+      continue;
+
+    const size_t before = matches;
+    const auto on_line = [&](size_t line_number, size_t start, size_t end) {
+      std::string_view line(text.data() + start, end - start);
+
+      if (line.ends_with('\r'))
+        line.remove_suffix(1);
+
+      logger.output(path + ":" + std::to_string(line_number) + ":" +
+                    std::string(line));
+      matches++;
+    };
+
+    if (regex)
+      find_regex(text, *expression, on_line);
+    else if (ignore_case) {
+      folded.resize(text.size());
+      std::ranges::transform(text, folded.begin(), search_index::fold);
+      find_text(folded, folded_pattern, on_line);
+    } else
+      find_text(text, pattern, on_line);
+
+    matched_files += (matches != before) ? 1 : 0;
+  }
+
+  /* Oversized files are never searched, their matches would otherwise be
+   * missed silently */
+  const size_t skipped =
+      std::ranges::count_if(index.files, [](const search_index::File &file) {
+        return !file.path.empty() && file.size > search_index::max_file_size;
+      });
+
+  std::string searched = std::to_string(candidates.size()) + " of " +
+                         std::to_string(index.files.size()) + " files searched";
+
+  if (skipped != 0)
+    searched += ", " + std::to_string(skipped) + " larger than " +
+                std::to_string(search_index::max_file_size >> 20) +
+                " MiB skipped";
+
+  logger.custom(std::to_string(matches) + " matches in " +
+                    std::to_string(matched_files) + " files (" + searched +
+                    ")",
+                "find", "theme");
+  return 0;
+}
@@ -0,0 +1,101 @@
+/**
+ * @file flags.cpp
+ * @brief Adds functionality to flag parsing
+ * @version 0.1
+ * @date 2025-03-02
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#include "../../include/commands/flags.h"
+#include "../../include/logger.h"
+
+#include <string>
+
+/**
+ * @brief Construct a new Flags object with every flag set to its default value
+ *
+ * @param _schema Flags accepted by command
+ */
+Flags::Flags(std::span<const Flag_Spec> _schema) : schema(_schema) {
+  for (size_t i = 0; i < schema.size(); i++)
+    values[i] = schema[i].default_value;
+}
+
+/**
+ * @brief Parses raw flag (-a, -a=value, --flag, --flag=value) against schema
+ *
+ * @param raw Raw flag
+ * @return true
+ * @return false (flag is unknown or malformed)
+ */
+bool Flags::parse(std::string_view raw) {
+  Logger &logger = Logger::get();
+
+  const bool is_short = !raw.starts_with("--");
+  std::string_view name = raw.substr(is_short ? 1 : 2), value;
+  const size_t eq = name.find('=');
+  const bool has_value = eq != std::string_view::npos;
+
+  if (has_value) {
+    value = name.substr(eq + 1);
+    name = name.substr(0, eq);
+  }
+
+  for (size_t i = 0; i < schema.size(); i++) {
+    const Flag_Spec &spec = schema[i];
+
+    if (!(is_short && name.size() == 1 ? spec.alias == name[0]
+                                       : spec.name == name))
+      continue;
+
+    if (spec.type == Flag_Type::boolean && has_value) {
+      logger.error_q("does not take a value", std::string(raw));
+      return false;
+    }
+
+    if (spec.type == Flag_Type::value && (!has_value || value.empty())) {
+      logger.error_q("requires a value (--" + std::string(spec.name) +
+                         "=value)",
+                     std::string(raw));
+      return false;
+    }
+
+    set(i, value);
+    return true;
+  }
+
+  logger.error_q("is not a valid flag for this command, try using --help",
+                 std::string(raw));
+  return false;
+}
+
+/**
+ * @brief Marks flag as present
+ *
+ * @param flag Index of flag in schema
+ * @param value Value of flag (value flags only)
+ */
+void Flags::set(size_t flag, std::string_view value) {
+  present.set(flag);
+
+  if (!value.empty())
+    values[flag] = value;
+}
+
+/**
+ * @brief Checks if flag was given
+ *
+ * @param flag Index of flag in schema
+ * @return true
+ * @return false
+ */
+bool Flags::has(size_t flag) const { return present.test(flag); }
+
+/**
+ * @brief Gets value of flag (default value if flag was not given)
+ *
+ * @param flag Index of flag in schema
+ * @return std::string_view
+ */
+std::string_view Flags::value(size_t flag) const { return values[flag]; }
\ No newline at end of file
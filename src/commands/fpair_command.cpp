@@ -8,10 +8,15 @@
  *
  */
 #include "../../include/commands/fpair_command.h"
+#include "../../include/commands/completions_command.h"
 
 #include "../../include/directory.h"
-#include "../../include/file.h"
 #include "../../include/misc.h"
+#include "../../include/paths.h"
+#include "../../include/templates.h"
+
+#include <algorithm>
+#include <set>
 
 /**
  * @brief Construct a new Fpair_Command object
@@ -27,76 +32,154 @@ Fpair_Command::Fpair_Command() {}
  * @return uint8_t
  */
 uint8_t Fpair_Command::execute(const std::vector<std::string> &args,
-                               const std::vector<std::string> &flags) const {
+                               const Flags &flags) const {
+  const bool hpp = flags.has(flag("hpp"));
+
+  if (args[0] == "remove")
+    return remove_pairs(
+        misc::sub_vector<std::string>(args, 1, args.size() - 1));
+
   /* Determines path prefixes */
   for (const auto &arg :
        misc::sub_vector<std::string>(args, 1, args.size() - 1)) {
     if (args[0] == "create") {
       const std::filesystem::path header_path(
-          directory::get_structured_header_path(
-              arg, (misc::vector_contains(flags, "hpp")))),
+          directory::get_structured_header_path(arg, hpp)),
           source_path(directory::get_structured_source_path(arg));
       std::filesystem::path source_include_path;
 
-      File header(header_path);
-      header.load({"#pragma once"});
-
       if (source_path.parent_path() == header_path.parent_path())
         source_include_path = header_path.stem();
       else
         source_include_path = arg;
 
-      File source(source_path);
-      source.load({"#include \"" + source_include_path.string() +
-                   (misc::vector_contains(flags, "hpp") ? ".hpp" : ".h") +
-                   "\""});
-    } else if (args[0] == "remove") {
-      directory::destroy_file("include/" + arg + ".h");
-      directory::destroy_file("include/" + arg + ".hpp");
-      directory::destroy_file("src/" + arg + ".c");
-      directory::destroy_file("src/" + arg + ".cpp");
-      directory::destroy_file(arg + ".h");
-      directory::destroy_file(arg + ".hpp");
-      directory::destroy_file(arg + ".c");
-      directory::destroy_file(arg + ".cpp");
+      templates::pair_header.render(plan->write(header_path));
+      templates::pair_source.render(plan->write(source_path),
+                                    plan->keep(source_include_path.native()),
+                                    hpp ? ".hpp" : ".h");
     } else {
       logger.error_q("is an invalid sub-command", args[0]);
       return 1;
     }
   }
 
+  update_completions(misc::sub_vector<std::string>(args, 1, args.size() - 1),
+                     {});
+
   return 0;
 }
 
 /**
- * @brief Gets description of command
+ * @brief Removes every file pair matching one of the patterns, which are
+ * matched against one listing of the root, src/ and include/ instead of
+ * checking every candidate path (a header in include/ or source in src/ also
+ * matches without its folder, like the paths fpair create uses)
  *
- * @return std::string
+ * @param patterns Pair names or glob patterns (see misc::glob_match)
+ * @return uint8_t
  */
-std::string Fpair_Command::get_description() const {
-  return "Creates a header-source file pair";
-}
+uint8_t
+Fpair_Command::remove_pairs(const std::vector<std::string> &patterns) const {
+  const std::string &root = paths::root();
+  std::pmr::vector<bool> matched(patterns.size(), false, memory);
 
-/**
- * @brief Gets command arguments
- *
- * @return std::string
- */
-std::string Fpair_Command::get_arguments() const {
-  return "[sub command] sub command of fpair to execute\t[file names] names of "
-         "file pairs to create (separated by spaces)";
+  std::pmr::vector<std::string_view> removed(memory);
+  const std::pmr::vector<std::pmr::string> files =
+      directory::list_pair_files(memory);
+
+  for (const auto &file : files) {
+    std::string_view name, structured_name;
+
+    if (!directory::split_pair_path(file, name, structured_name))
+      continue;
+
+    bool remove = false;
+
+    for (size_t i = 0; i < patterns.size(); i++)
+      if (misc::glob_match(patterns[i], name) ||
+          misc::glob_match(patterns[i], structured_name))
+        remove = matched[i] = true;
+
+    if (remove) {
+      plan->remove(root + "/" + std::string(file), true);
+      removed.push_back(structured_name);
+    }
+  }
+
+  /* Pairs fpair create put in folders of a simple project aren't listed,
+   * names without wildcards still remove them */
+  for (size_t i = 0; i < patterns.size(); i++) {
+    const std::string &pattern = patterns[i];
+
+    if (pattern.find_first_of("*?") != std::string::npos ||
+        pattern.find('/') == std::string::npos ||
+        pattern.starts_with("src/") || pattern.starts_with("include/"))
+      continue;
+
+    for (const std::string_view extension : {".h", ".hpp", ".c", ".cpp"}) {
+      const std::filesystem::path path(pattern + std::string(extension));
+
+      if (!plan->exists(path))
+        continue;
+
+      plan->remove(path);
+
+      if (!matched[i])
+        removed.push_back(pattern);
+
+      matched[i] = true;
+    }
+  }
+
+  for (size_t i = 0; i < patterns.size(); i++)
+    if (!matched[i])
+      logger.warn_q("does not match any file pair", patterns[i]);
+
+  update_completions({}, removed);
+
+  return 0;
 }
 
 /**
- * @brief Gets command flags
+ * @brief Plans completion cache of project (pair names completed by the
+ * scripts of cpm completions) with pairs added and removed, a missing cache
+ * is built from the headers of one listing of the root, src/ and include/
  *
- * @return std::string
+ * @param created Structured names of created pairs
+ * @param removed Structured names of removed pairs
  */
-std::string Fpair_Command::get_flags() const { return "None"; }
+void Fpair_Command::update_completions(
+    std::span<const std::string> created,
+    std::span<const std::string_view> removed) const {
+  const std::filesystem::path cache_path(Completions_Command::cache_path);
+  std::pmr::set<std::string_view> names(memory);
+  std::string cached;
 
-/**
- * @brief Gets minimum arguments
- *
- * @return uint16_t
- */
-uint16_t Fpair_Command::get_min_args() const { return 2; }
\ No newline at end of file
+  if (plan->exists(cache_path)) {
+    cached = plan->contents(cache_path);
+
+    for (const auto &name : misc::split_string(cached, "\n", memory))
+      if (!name.empty())
+        names.insert(name);
+  } else {
+    for (const auto &file : directory::list_pair_files(memory)) {
+      std::string_view name, structured_name;
+
+      /* Every pair has a header (interfaces have no source) */
+      if (directory::split_pair_path(file, name, structured_name) &&
+          !file.ends_with(".c") && !file.ends_with(".cpp"))
+        names.insert(plan->keep(structured_name));
+    }
+  }
+
+  for (const auto &name : created)
+    names.insert(name);
+
+  for (const auto &name : removed)
+    names.erase(name);
+
+  Emitter &out = plan->write(cache_path);
+
+  for (const auto &name : names)
+    out.line({plan->keep(name)});
+}
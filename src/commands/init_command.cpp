@@ -11,8 +11,14 @@
 
 #include "../../include/config.h"
 #include "../../include/directory.h"
+#include "../../include/emitter.h"
 #include "../../include/file.h"
 #include "../../include/misc.h"
+#include "../../include/paths.h"
+#include "../../include/templates.h"
+#include "../../include/toolchain.h"
+
+#include <algorithm>
 
 /**
  * @brief Construct a new Init_Command object
@@ -28,7 +34,7 @@ Init_Command::Init_Command() {}
  * @return uint8_t
  */
 uint8_t Init_Command::execute(const std::vector<std::string> &args,
-                              const std::vector<std::string> &flags) const {
+                              const Flags &flags) const {
   /* Language parsing */
   std::string lang = args[0];
 
@@ -40,170 +46,276 @@ uint8_t Init_Command::execute(const std::vector<std::string> &args,
     return 1;
   }
 
-  /* Prompt project name */
-  const std::string project_name = logger.prompt("enter project name");
+  const bool no_prompt = flags.has(flag("no-prompt"));
+
+  /* Preset (preset_<name>_<setting> config keys) */
+  const std::string preset_prefix =
+      flags.has(flag("preset"))
+          ? "preset_" + std::string(flags.value(flag("preset"))) + "_"
+          : "";
+
+  if (!preset_prefix.empty() &&
+      !data_manager.config_has_key(preset_prefix + "structure") &&
+      !data_manager.config_has_key(preset_prefix + "git") &&
+      !data_manager.config_has_key(preset_prefix + "std")) {
+    logger.error_q("preset does not exist, set it with cpm config set " +
+                       preset_prefix + "structure [structure]",
+                   std::string(flags.value(flag("preset"))));
+    return 1;
+  }
+
+  /* Project name */
+  std::string project_name(flags.value(flag("name")));
+
+  if (project_name.empty() && !flags.has(flag("workspace"))) {
+    if (no_prompt) {
+      logger.error("project name is required in no-prompt mode, use "
+                   "--name=[project name]");
+      return 1;
+    }
+
+    project_name = logger.prompt("enter project name");
+  }
 
   /* Directory structure */
   const std::string default_structure =
       data_manager.config_has_key("default_structure")
-          ? data_manager.config["default_structure"]
+          ? data_manager.get_value("default_structure")
           : "executable";
-  std::string structure;
+  std::string structure(flags.value(flag("structure")));
 
-  /* Prompt structure */
-  while (true) {
-    structure =
-        logger.prompt("enter project structure (hit enter for default '" +
-                      default_structure + "')");
+  if (structure.empty() && !preset_prefix.empty())
+    structure = data_manager.get_value(preset_prefix + "structure");
 
-    if (structure == "")
-      structure = default_structure;
+  if (structure.empty() && no_prompt)
+    structure = default_structure;
 
-    if (!misc::vector_contains(supported_structures, structure))
-      logger.warn_q("is an invald template name", structure);
-    else
-      break;
-  }
+  if (!structure.empty()) {
+    if (!misc::vector_contains(supported_structures, structure)) {
+      logger.error_q("is an invald template name", structure);
+      return 1;
+    }
+  } else {
+    /* Prompt structure */
+    while (true) {
+      structure =
+          logger.prompt("enter project structure (hit enter for default '" +
+                        default_structure + "')");
 
-  const bool git_support = logger.prompt_yn("add git support");
+      if (structure == "")
+        structure = default_structure;
 
-  /* Set main path */
-  std::string main_path;
+      if (!misc::vector_contains(supported_structures, structure))
+        logger.warn_q("is an invald template name", structure);
+      else
+        break;
+    }
+  }
 
-  if (structure == "executable") {
-    directory::create_folders({"src", "include", "build", "tests", "lib"});
+  /* Git support */
+  bool git_support;
 
-    main_path = "src/main";
-    main_path += ((lang == "cpp") ? ".cpp" : ".c");
+  if (flags.has(flag("git")))
+    git_support = true;
+  else if (!preset_prefix.empty() &&
+           data_manager.config_has_key(preset_prefix + "git")) {
+    const std::string preset_git =
+        data_manager.get_value(preset_prefix + "git");
+    git_support =
+        preset_git == "on" || preset_git == "yes" || preset_git == "true";
+  } else if (no_prompt)
+    git_support = false;
+  else
+    git_support = logger.prompt_yn("add git support");
 
-    /* Get installed CMake version */
-    logger.execute("cmake --version > cpm.tmp");
+  /* Language standard */
+  std::string lang_version(flags.value(flag("std")));
 
-    std::ifstream result_file("cpm.tmp");
-    if (!misc::ifstream_open(result_file))
-      return 1;
+  if (lang_version.empty() && !preset_prefix.empty())
+    lang_version = data_manager.get_value(preset_prefix + "std");
 
-    std::string cmake_current_version;
-    std::getline(result_file, cmake_current_version);
-    cmake_current_version = misc::split_string(cmake_current_version, " ")[2];
+  if (lang_version.empty())
+    lang_version = (lang == "cpp") ? cpp_default_standard : c_default_standard;
 
-    result_file.close();
+  /* Get installed CMake version once (cached in config) */
+  Project_Settings settings{lang, structure, git_support, lang_version, ""};
 
-    /* Setup CMake variables / file */
-    const std::string cmake_lang = (lang == "cpp") ? "CXX" : "C";
-    const std::string lang_version =
-        (flags.size() > 0)
-            ? misc::get_flag_value(flags[0])
-            : ((lang == "cpp") ? cpp_default_standard : c_default_standard);
-
-    File cmake_lists("CMakeLists.txt");
-    cmake_lists.load({
-        "cmake_minimum_required(VERSION " + cmake_current_version + ")",
-        "",
-        "project(",
-        "\t" + project_name,
-        "\tLANGUAGES " + cmake_lang,
-        ")",
-        "",
-        "set(CMAKE_" + cmake_lang + "_STANDARD " + lang_version + ")",
-        "set(SOURCE_DIR ${CMAKE_CURRENT_SOURCE_DIR}/src)",
-        "",
-        "file(GLOB_RECURSE SOURCES \"${SOURCE_DIR}/*." +
-            std::string((lang == "cpp") ? "cpp" : "c") + "\")",
-        "",
-        "add_executable(",
-        "\t${PROJECT_NAME}",
-        "\t${SOURCES}",
-        ")",
-        "",
-        "target_include_directories(",
-        "\t${PROJECT_NAME} PRIVATE",
-        "\t${CMAKE_CURRENT_SOURCE_DIR}/include",
-        ")",
-        "",
-        "target_link_libraries(",
-        "\t${PROJECT_NAME} PRIVATE",
-        ")",
-        "",
-        "install(TARGETS ${PROJECT_NAME} DESTINATION /usr/local/bin)",
-    });
-  } else if (structure == "simple") {
-    main_path = "main";
-    main_path += (lang == "cpp") ? ".cpp" : ".c";
-  }
+  if (structure == "executable") {
+    settings.cmake_version = toolchain::get_cmake_version();
 
-  if (git_support) {
-    File gitignore(".gitignore");
-    gitignore.load({
-        "# CMake artifacts",
-        "build",
-        "CMakeFiles/",
-        "CMakeCache.txt",
-        "CMakeScripts/",
-        "cmake_install.cmake",
-        "Makefile",
-        "",
-        "# Testing",
-        "tests",
-        "",
-        "# Others",
-        ".exe",
-        ".vscode/",
-        ".DS_Store",
-    });
-
-    File readme("README.md");
-    readme.load({"# " + project_name});
-
-    directory::create_file("LICENSE");
+    if (settings.cmake_version.empty())
+      return 1;
   }
 
-  File main_file(main_path);
+  if (flags.has(flag("workspace")))
+    return create_workspace(std::string(flags.value(flag("workspace"))),
+                            settings);
 
-  main_file.load({
-      "#include <iostream>",
-      "",
-      "int main(int argc, char *argv[]) {",
-      "\tstd::cout << \"Hello World!\" << std::endl;",
-      "\treturn 0;",
-      "}",
-  });
+  create_project(*plan, ".", project_name, settings);
 
   return 0;
 }
 
 /**
- * @brief Gets description of command
+ * @brief Plans project files inside root
  *
- * @return std::string
+ * @param plan Plan to record files into
+ * @param root Project directory
+ * @param project_name Name of project
+ * @param settings Project settings
  */
-std::string Init_Command::get_description() const {
-  return "Initializes a new c/cpp project in working directory";
-}
+void Init_Command::create_project(Plan &plan, const std::filesystem::path &root,
+                                  std::string_view project_name,
+                                  const Project_Settings &settings) {
+  const std::string &lang = settings.lang;
+  const std::string_view name = plan.keep(project_name);
 
-/**
- * @brief Gets command arguments
- *
- * @return std::string
- */
-std::string Init_Command::get_arguments() const {
-  return "[language] language project is based in";
+  /* Set main path */
+  std::string main_path;
+
+  if (settings.structure == "executable") {
+    for (const auto &folder : {"src", "include", "build", "tests", "lib"})
+      plan.mkdir(root / folder);
+
+    main_path = "src/main";
+    main_path += ((lang == "cpp") ? ".cpp" : ".c");
+
+    /* Setup CMake variables / file */
+    const std::string_view cmake_lang = (lang == "cpp") ? "CXX" : "C";
+
+    templates::cmake_lists.render(
+        plan.write(root / "CMakeLists.txt"), plan.keep(settings.cmake_version),
+        name, cmake_lang, plan.keep(settings.lang_version),
+        (lang == "cpp") ? "cpp" : "c");
+  } else if (settings.structure == "simple") {
+    main_path = "main";
+    main_path += (lang == "cpp") ? ".cpp" : ".c";
+  }
+
+  if (settings.git_support) {
+    templates::gitignore.render(plan.write(root / ".gitignore"));
+    templates::readme.render(plan.write(root / "README.md"), name);
+    plan.create(root / "LICENSE");
+  }
+
+  if (lang == "cpp")
+    templates::cpp_main.render(plan.write(root / main_path));
+  else
+    templates::c_main.render(plan.write(root / main_path));
 }
 
 /**
- * @brief Gets command flags
+ * @brief Reads workspace members from spec, either a comma-separated list of
+ * project directories or a file listing one project directory per line
+ * (blank lines and lines starting with '#' are skipped)
+ *
+ * Every member must be a distinct folder below the workspace root: absolute
+ * members, members leaving it through "..", empty members, the root itself
+ * and duplicates are reported.
  *
- * @return std::string
+ * @param spec Workspace spec
+ * @param members Members to append to (normalized, without trailing '/')
+ * @param memory Memory resource for temporary name list
+ * @return true
+ * @return false if a member was rejected
  */
-std::string Init_Command::get_flags() const {
-  return "-s=[language standard] specify a specific language standard to use "
-         "instead of C" +
-         c_default_standard + " or C++" + cpp_default_standard;
+bool Init_Command::read_workspace_members(
+    const std::string &spec, std::vector<std::filesystem::path> &members,
+    std::pmr::memory_resource *memory) {
+  std::vector<std::string> lines;
+  std::pmr::vector<std::string_view> names(memory);
+  const bool from_file = directory::has_file(spec) &&
+                         !directory::has_folder(spec);
+
+  if (from_file) {
+    File spec_file(spec);
+    lines = spec_file.read();
+    names.assign(lines.begin(), lines.end());
+  } else
+    names = misc::split_string(spec, ",", memory);
+
+  bool valid = true;
+
+  for (const auto &name : names) {
+    if (from_file && (name.empty() || name[0] == '#'))
+      continue;
+
+    if (name.empty()) {
+      logger.error_q("contains an empty workspace member", spec);
+      valid = false;
+      continue;
+    }
+
+    const std::string quoted(name);
+    std::filesystem::path member =
+        std::filesystem::path(name).lexically_normal();
+
+    if (!member.has_filename() && member.has_parent_path())
+      member = member.parent_path(); // Trailing '/'
+
+    if (member.is_absolute()) {
+      logger.error_q("is an absolute path, workspace members must be inside "
+                     "the workspace",
+                     quoted);
+      valid = false;
+    } else if (member.empty() || member == ".") {
+      logger.error_q("is the workspace root, workspace members must be "
+                     "folders inside it",
+                     quoted);
+      valid = false;
+    } else if (*member.begin() == "..") {
+      logger.error_q("is outside the workspace", quoted);
+      valid = false;
+    } else if (std::find(members.begin(), members.end(), member) !=
+               members.end()) {
+      logger.error_q("is listed more than once", quoted);
+      valid = false;
+    } else
+      members.push_back(member);
+  }
+
+  return valid;
 }
 
 /**
- * @brief Gets minimum arguments
+ * @brief Plans every workspace member (their files are written concurrently
+ * when the plan is executed) and a top-level CMakeLists.txt including every
+ * member
  *
- * @return uint16_t
+ * @param spec Workspace spec
+ * @param settings Settings shared by every member
+ * @return uint8_t
  */
-uint16_t Init_Command::get_min_args() const { return 1; }
\ No newline at end of file
+uint8_t Init_Command::create_workspace(const std::string &spec,
+                                       const Project_Settings &settings) const {
+  std::vector<std::filesystem::path> members;
+
+  if (!read_workspace_members(spec, members, memory))
+    return 1;
+
+  if (members.empty()) {
+    logger.error_q("does not contain any projects", spec);
+    return 1;
+  }
+
+  for (const auto &member : members)
+    create_project(*plan, member, member.filename().native(), settings);
+
+  /* Top-level CMakeLists.txt (only executable projects have CMake files) */
+  if (settings.structure == "executable") {
+    Emitter &cmake_out = plan->write("CMakeLists.txt");
+    templates::workspace_cmake_lists.render(
+        cmake_out, plan->keep(settings.cmake_version),
+        plan->keep(std::filesystem::path(paths::root()).filename().native()),
+        (settings.lang == "cpp") ? "CXX" : "C");
+
+    for (const auto &member : members)
+      templates::workspace_member.render(cmake_out,
+                                         plan->keep(member.native()));
+  }
+
+  plan->on_success("created workspace with " +
+                   std::to_string(members.size()) + " projects");
+
+  return 0;
+}
\ No newline at end of file
@@ -0,0 +1,252 @@
+/**
+ * @file stats_command.cpp
+ * @brief Adds functionality to stats command
+ * @version 0.1
+ * @date 2025-06-01
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#include "../../include/commands/stats_command.h"
+
+#include "../../include/emitter.h"
+#include "../../include/history.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <map>
+#include <span>
+
+namespace {
+/**
+ * @brief Statistics of the recorded runs of one command
+ *
+ */
+struct Summary {
+  size_t runs = 0;
+  size_t failures = 0;
+  double p50 = 0, p95 = 0, p99 = 0; // Milliseconds
+  double total = 0;                 // Milliseconds
+  double trend = 0;      // Change of median, newer half against older half
+  bool has_trend = false; // Needs at least 4 runs
+  uint64_t read_calls = 0, write_calls = 0; // Mean per run
+  int64_t last_run = 0;                     // Milliseconds since the epoch
+};
+
+/**
+ * @brief Gets nearest-rank percentile of sorted values
+ *
+ * @param sorted Values (sorted, not empty)
+ * @param p Percentile (0 to 1)
+ * @return double
+ */
+double percentile(std::span<const double> sorted, double p) {
+  const size_t rank =
+      static_cast<size_t>(std::ceil(p * static_cast<double>(sorted.size())));
+
+  return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+/**
+ * @brief Gets median of values
+ *
+ * @param values Values (sorted in place, not empty)
+ * @return double
+ */
+double median(std::span<double> values) {
+  std::ranges::sort(values);
+  return percentile(values, 0.5);
+}
+
+/**
+ * @brief Formats number with a fixed number of decimals
+ *
+ * @param value Number
+ * @param precision Number of decimals
+ * @return std::string
+ */
+std::string fixed(double value, int precision) {
+  std::array<char, 64> buffer;
+  const auto result =
+      std::to_chars(buffer.data(), buffer.data() + buffer.size(), value,
+                    std::chars_format::fixed, precision);
+
+  return {buffer.data(), result.ptr};
+}
+
+/**
+ * @brief Summarizes runs of one command
+ *
+ * @param runs Runs (oldest first, not empty)
+ * @return Summary
+ */
+Summary summarize(std::span<const history::Record *const> runs) {
+  Summary summary;
+  std::vector<double> times;
+  times.reserve(runs.size());
+
+  for (const history::Record *run : runs) {
+    const double time = static_cast<double>(run->wall_time) / 1000.0;
+    times.push_back(time);
+
+    summary.total += time;
+    summary.failures += run->exit_code != 0;
+    summary.read_calls += run->read_calls;
+    summary.write_calls += run->write_calls;
+    summary.last_run = std::max(summary.last_run, run->time);
+  }
+
+  summary.runs = runs.size();
+  summary.read_calls /= summary.runs;
+  summary.write_calls /= summary.runs;
+
+  /* Trend before sorting, while times are still oldest first */
+  if (times.size() >= 4) {
+    const size_t half = times.size() / 2;
+    std::vector<double> older(times.begin(), times.begin() + half),
+        newer(times.end() - half, times.end());
+    const double older_median = median(older);
+
+    if (older_median > 0) {
+      summary.trend = (median(newer) - older_median) / older_median;
+      summary.has_trend = true;
+    }
+  }
+
+  std::ranges::sort(times);
+  summary.p50 = percentile(times, 0.50);
+  summary.p95 = percentile(times, 0.95);
+  summary.p99 = percentile(times, 0.99);
+
+  return summary;
+}
+
+/**
+ * @brief Renders summaries in the node_exporter textfile format
+ *
+ * @param summaries Summaries by command
+ * @return std::string
+ */
+std::string
+render_textfile(const std::map<std::string_view, Summary> &summaries) {
+  /* Values cover the runs kept in history, so they drop once old runs are
+   * dropped and are gauges (summary _sum and _count must only grow) */
+  std::string text =
+      "# HELP cpm_command_duration_seconds Wall time quantiles of recent cpm "
+      "runs\n"
+      "# TYPE cpm_command_duration_seconds gauge\n";
+
+  for (const auto &[command, summary] : summaries) {
+    const std::string label = "{command=\"" + std::string(command) + "\"";
+
+    for (const auto &[quantile, value] :
+         {std::pair{"0.5", summary.p50}, std::pair{"0.95", summary.p95},
+          std::pair{"0.99", summary.p99}})
+      text += "cpm_command_duration_seconds" + label + ",quantile=\"" +
+              quantile + "\"} " + fixed(value / 1000.0, 6) + "\n";
+  }
+
+  /* One metric family after the other, as the format requires */
+  struct Gauge {
+    std::string_view metric, help;
+    std::string (*value)(const Summary &);
+  };
+
+  const std::array<Gauge, 6> gauges = {{
+      {"cpm_command_recent_duration_seconds",
+       "Wall time of the recent cpm runs added up",
+       [](const Summary &s) { return fixed(s.total / 1000.0, 6); }},
+      {"cpm_command_recent_runs", "Recent cpm runs",
+       [](const Summary &s) { return std::to_string(s.runs); }},
+      {"cpm_command_failures", "Recent cpm runs with a non-zero exit code",
+       [](const Summary &s) { return std::to_string(s.failures); }},
+      {"cpm_command_read_syscalls", "Mean read-like system calls per run",
+       [](const Summary &s) { return std::to_string(s.read_calls); }},
+      {"cpm_command_write_syscalls", "Mean write-like system calls per run",
+       [](const Summary &s) { return std::to_string(s.write_calls); }},
+      {"cpm_command_last_run_timestamp_seconds", "End of the latest run",
+       [](const Summary &s) {
+         return fixed(static_cast<double>(s.last_run) / 1000.0, 3);
+       }},
+  }};
+
+  for (const auto &gauge : gauges) {
+    const std::string metric(gauge.metric);
+
+    text += "# HELP " + metric + " " + std::string(gauge.help) + "\n# TYPE " +
+            metric + " gauge\n";
+
+    for (const auto &[command, summary] : summaries)
+      text += metric + "{command=\"" + std::string(command) + "\"} " +
+              gauge.value(summary) + "\n";
+  }
+
+  return text;
+}
+} // namespace
+
+/**
+ * @brief Construct a new Stats_Command object
+ *
+ */
+Stats_Command::Stats_Command() {}
+
+/**
+ * @brief Execute stats command
+ *
+ * @param args
+ * @param flags
+ * @return uint8_t
+ */
+uint8_t Stats_Command::execute(const std::vector<std::string> &args,
+                               const Flags &flags) const {
+  const std::vector<history::Record> records = history::read();
+
+  /* Runs by command, oldest first */
+  std::map<std::string_view, std::vector<const history::Record *>> runs;
+
+  for (const auto &record : records) {
+    const std::string_view command = record.get_command();
+
+    if (args.empty() || std::ranges::find(args, command) != args.end())
+      runs[command].push_back(&record);
+  }
+
+  if (runs.empty())
+    logger.warn("no recorded runs" +
+                (records.empty() ? "" : std::string(" of these commands")) +
+                " in " + history::location().string());
+
+  std::map<std::string_view, Summary> summaries;
+
+  for (const auto &[command, command_runs] : runs) {
+    const Summary &summary = summaries[command] = summarize(command_runs);
+
+    logger.custom(
+        std::to_string(summary.runs) + " runs" +
+            (summary.failures != 0
+                 ? " (" + std::to_string(summary.failures) + " failed)"
+                 : "") +
+            "  p50 " + fixed(summary.p50, 1) + " ms  p95 " +
+            fixed(summary.p95, 1) + " ms  p99 " + fixed(summary.p99, 1) +
+            " ms  trend " +
+            (summary.has_trend
+                 ? (summary.trend >= 0 ? "+" : "") +
+                       fixed(summary.trend * 100.0, 0) + "%"
+                 : "n/a") +
+            "  io " + std::to_string(summary.read_calls) + " reads, " +
+            std::to_string(summary.write_calls) + " writes",
+        std::string(command), "theme");
+  }
+
+  if (flags.has(flag("export"))) {
+    const std::string_view path = flags.value(flag("export"));
+
+    /* Renamed into place, node_exporter never reads half a file */
+    plan->replace(path).append(plan->keep(render_textfile(summaries)));
+  }
+
+  return 0;
+}
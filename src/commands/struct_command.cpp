@@ -11,8 +11,8 @@
 #include "../../include/commands/fpair_command.h"
 
 #include "../../include/directory.h"
-#include "../../include/file.h"
 #include "../../include/misc.h"
+#include "../../include/templates.h"
 
 #include <filesystem>
 
@@ -30,13 +30,21 @@ Struct_Command::Struct_Command() {}
  * @return uint8_t
  */
 uint8_t Struct_Command::execute(const std::vector<std::string> &args,
-                                const std::vector<std::string> &flags) const {
+                                const Flags &flags) const {
   /* Create file pairs */
   std::vector<std::string> file_pair_args(args);
   file_pair_args.insert(file_pair_args.begin(), "create");
 
+  Flags file_pair_flags(Fpair_Command::flag_schema);
+
+  if (flags.has(flag("hpp")))
+    file_pair_flags.set(Fpair_Command::flag("hpp"));
+
   Fpair_Command fpair_command;
-  const uint8_t result = fpair_command.execute(file_pair_args, flags);
+  fpair_command.set_memory_resource(memory);
+  fpair_command.set_plan(plan);
+  const uint8_t result =
+      fpair_command.execute(file_pair_args, file_pair_flags);
 
   if (result != 0)
     return result;
@@ -51,66 +59,25 @@ uint8_t Struct_Command::execute(const std::vector<std::string> &args,
     _struct_name = std::filesystem::absolute(_arg).filename().string();
     misc::auto_capitalize(struct_name = _struct_name);
 
-    File header(directory::get_structured_header_path(
-        arg, misc::vector_contains(flags, "hpp"))),
-        source(directory::get_structured_source_path(arg));
-
-    if (!misc::vector_contains(flags, "ntypedef")) {
-      header.write({"typedef struct {", "\t", "} " + struct_name + ";", "",
-                    struct_name + " *create_" + _struct_name + "();"});
-
-      source.write(
-          {struct_name + " *create_" + _struct_name + "() {", "\t", "}"});
+    /* Appended to what fpair planned */
+    const std::filesystem::path header_path(
+        directory::get_structured_header_path(arg, flags.has(flag("hpp")))),
+        source_path(directory::get_structured_source_path(arg));
+    const std::string_view name = plan->keep(struct_name),
+                           file_name = plan->keep(_struct_name);
+
+    if (!flags.has(flag("ntypedef"))) {
+      templates::typedef_struct_header.render(plan->append(header_path), name,
+                                              file_name);
+      templates::typedef_struct_source.render(plan->append(source_path), name,
+                                              file_name);
     } else {
-      header.write({
-          "struct " + struct_name + " {",
-          "",
-          "}",
-          "",
-          "struct " + struct_name + " *create_" + _struct_name + "();",
-      });
-
-      source.write({
-          "struct " + struct_name + " *create_" + _struct_name + "() {",
-          "",
-          "}",
-      });
+      templates::struct_header.render(plan->append(header_path), name,
+                                      file_name);
+      templates::struct_source.render(plan->append(source_path), name,
+                                      file_name);
     }
   }
 
   return 0;
-}
-
-/**
- * @brief Gets description of command
- *
- * @return std::string
- */
-std::string Struct_Command::get_description() const {
-  return "Creates a struct based header-source file pair";
-}
-
-/**
- * @brief Gets command arguments
- *
- * @return std::string
- */
-std::string Struct_Command::get_arguments() const {
-  return "[names] names of files that will contain structs";
-}
-
-/**
- * @brief Gets command flags
- *
- * @return std::string
- */
-std::string Struct_Command::get_flags() const {
-  return "--ntypedef don't use typedef keyword";
-}
-
-/**
- * @brief Gets minimum arguments
- *
- * @return uint16_t
- */
-uint16_t Struct_Command::get_min_args() const { return 1; }
\ No newline at end of file
+}
\ No newline at end of file
@@ -25,37 +25,7 @@ Version_Command::Version_Command() {}
  * @return uint8_t
  */
 uint8_t Version_Command::execute(const std::vector<std::string> &args,
-                                 const std::vector<std::string> &flags) const {
+                                 const Flags &flags) const {
   logger.custom(version_string, "version", "theme");
   return 0;
-}
-
-/**
- * @brief Gets description of command
- *
- * @return std::string
- */
-std::string Version_Command::get_description() const {
-  return "Logs installed version of CPM";
-}
-
-/**
- * @brief Gets command arguments
- *
- * @return std::string
- */
-std::string Version_Command::get_arguments() const { return "None"; }
-
-/**
- * @brief Gets command flags
- *
- * @return std::string
- */
-std::string Version_Command::get_flags() const { return "None"; }
-
-/**
- * @brief Gets minimum arguments
- *
- * @return uint16_t
- */
-uint16_t Version_Command::get_min_args() const { return 0; }
\ No newline at end of file
+}
\ No newline at end of file
@@ -0,0 +1,465 @@
+/**
+ * @file watch_command.cpp
+ * @brief Adds functionality to watch command
+ * @version 0.1
+ * @date 2025-06-08
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#include "../../include/commands/watch_command.h"
+#include "../../include/commands/completions_command.h"
+
+#include "../../include/directory.h"
+#include "../../include/emitter.h"
+#include "../../include/file_index.h"
+#include "../../include/paths.h"
+#include "../../include/vfs.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <poll.h>
+#include <set>
+#include <sys/inotify.h>
+#include <sys/signalfd.h>
+#include <unistd.h>
+#include <unordered_map>
+
+namespace {
+/* Changes to the entries of a folder (contents of files don't change the
+ * index) */
+constexpr uint32_t folder_events = IN_CREATE | IN_DELETE | IN_MOVED_FROM |
+                                   IN_MOVED_TO | IN_ONLYDIR;
+
+/* A burst that never quiets down is applied this many debounce times after
+ * it started */
+constexpr int max_debounce_factor = 10;
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief One inotify event
+ *
+ */
+struct Event {
+  int watch;
+  uint32_t mask;
+  std::string name;
+};
+
+/**
+ * @brief Keeps file index and completion cache in step with inotify events
+ * of every indexed folder
+ *
+ */
+class Watcher {
+private:
+  Logger &logger = Logger::get();
+  int inotify = -1;
+  std::unordered_map<int, std::string> folders; // By watch descriptor
+  std::set<std::string, std::less<>> watched;
+  std::string completions; // Cache contents last written
+  bool warned = false;     // Watch limit reached
+
+  void unwatch(std::string_view folder);
+
+public:
+  file_index::Index index;
+
+  Watcher();
+
+  ~Watcher();
+
+  int fd() const { return inotify; }
+
+  bool watch_new_folders();
+
+  bool read_events(std::vector<Event> &events);
+
+  size_t apply(const std::vector<Event> &events);
+
+  std::string completion_text() const;
+
+  bool save();
+};
+
+/**
+ * @brief Construct a new Watcher object
+ *
+ */
+Watcher::Watcher() : inotify(inotify_init1(IN_NONBLOCK | IN_CLOEXEC)) {
+  Vfs::current().read(Completions_Command::cache_path, completions);
+}
+
+/**
+ * @brief Destroy the Watcher object (removes every watch)
+ *
+ */
+Watcher::~Watcher() {
+  if (inotify >= 0)
+    close(inotify);
+}
+
+/**
+ * @brief Removes watches of folder and every folder below it (a folder moved
+ * out of the project must not report changes under its old path)
+ *
+ * @param folder Path relative to project root
+ */
+void Watcher::unwatch(std::string_view folder) {
+  const std::string prefix = std::string(folder) + "/";
+
+  for (auto it = folders.begin(); it != folders.end();) {
+    if (it->second != folder && !it->second.starts_with(prefix)) {
+      ++it;
+      continue;
+    }
+
+    inotify_rm_watch(inotify, it->first);
+    watched.erase(it->second);
+    it = folders.erase(it);
+  }
+}
+
+/**
+ * @brief Watches every indexed folder that isn't watched yet, a folder that
+ * changed before its watch was added is read again
+ *
+ * @return true
+ * @return false if the index changed (new folders may need watches)
+ */
+bool Watcher::watch_new_folders() {
+  std::vector<std::string> missed;
+
+  for (const auto &[folder, stamp] : index.folders) {
+    if (watched.contains(folder))
+      continue;
+
+    const int watch = inotify_add_watch(
+        inotify, paths::absolute(folder).c_str(), folder_events);
+
+    if (watch < 0) {
+      if (!warned)
+        logger.warn_q("could not be watched (" +
+                          std::string(std::strerror(errno)) +
+                          "), it is listed by walking it while it changes",
+                      folder);
+
+      warned = true;
+      continue;
+    }
+
+    folders.insert_or_assign(watch, folder);
+    watched.insert(folder);
+
+    /* Stamped before its watch existed */
+    file_index::Index check;
+
+    if (!check.stamp(folder) || check.folders.begin()->second != stamp)
+      missed.push_back(folder);
+  }
+
+  for (const auto &folder : missed) {
+    index.remove_tree(folder);
+    index.add_tree(folder);
+  }
+
+  return missed.empty();
+}
+
+/**
+ * @brief Reads every queued event
+ *
+ * @param events Events to append to
+ * @return true
+ * @return false if the queue overflowed (events were lost)
+ */
+bool Watcher::read_events(std::vector<Event> &events) {
+  alignas(inotify_event) std::array<char, 64 * 1024> buffer;
+  bool complete = true;
+
+  while (true) {
+    const ssize_t size = read(inotify, buffer.data(), buffer.size());
+
+    if (size <= 0)
+      return complete;
+
+    for (ssize_t offset = 0; offset < size;) {
+      const auto *event =
+          reinterpret_cast<const inotify_event *>(buffer.data() + offset);
+      offset += sizeof(inotify_event) + event->len;
+
+      if (event->mask & IN_Q_OVERFLOW)
+        complete = false;
+      else
+        events.push_back({event->wd, event->mask,
+                          event->len > 0 ? std::string(event->name) : ""});
+    }
+  }
+}
+
+/**
+ * @brief Applies events to index, every folder they happened in is stamped
+ * again afterwards
+ *
+ * @param events Events (in the order they happened)
+ * @return size_t Number of files and folders added or removed
+ */
+size_t Watcher::apply(const std::vector<Event> &events) {
+  std::set<std::string, std::less<>> touched;
+  size_t changes = 0;
+
+  for (const auto &event : events) {
+    const auto it = folders.find(event.watch);
+
+    if (it == folders.end())
+      continue;
+
+    if (event.mask & IN_IGNORED) { // Folder is gone
+      watched.erase(it->second);
+      folders.erase(it);
+      continue;
+    }
+
+    const std::string folder = it->second;
+    const std::string path =
+        (folder == ".") ? event.name : folder + "/" + event.name;
+    const bool added = event.mask & (IN_CREATE | IN_MOVED_TO);
+
+    touched.insert(folder);
+    changes++;
+
+    if (!(event.mask & IN_ISDIR)) {
+      if (added)
+        index.files.insert(path);
+      else if (const auto file = index.files.find(path);
+               file != index.files.end())
+        index.files.erase(file);
+
+      continue;
+    }
+
+    if (directory::skipped_folder(
+            event.name, (folder == ".") ? 0 : paths::segment_count(folder)))
+      continue;
+
+    unwatch(path);
+    index.remove_tree(path);
+
+    if (added)
+      index.add_tree(path);
+  }
+
+  for (const auto &folder : touched)
+    if (index.folders.contains(folder) && !index.stamp(folder))
+      index.remove_tree(folder);
+
+  return changes;
+}
+
+/**
+ * @brief Gets contents of the completion cache for the pairs in index
+ *
+ * @return std::string
+ */
+std::string Watcher::completion_text() const {
+  std::set<std::string_view> names;
+
+  /* Every pair has a header (interfaces have no source), like fpair seeds
+   * the cache */
+  for (const auto &file : index.files) {
+    std::string_view name, structured_name;
+
+    if (directory::split_pair_path(file, name, structured_name) &&
+        !file.ends_with(".c") && !file.ends_with(".cpp"))
+      names.insert(structured_name);
+  }
+
+  std::string text;
+
+  for (const auto &name : names)
+    text.append(name).push_back('\n');
+
+  return text;
+}
+
+/**
+ * @brief Writes index and, if the pairs in it changed, completion cache
+ *
+ * @return true
+ * @return false
+ */
+bool Watcher::save() {
+  std::string text = completion_text();
+  bool success = index.save();
+
+  if (text != completions) {
+    completions = std::move(text);
+
+    Emitter content;
+    content.append(completions);
+    success =
+        Vfs::current().replace(Completions_Command::cache_path, content) &&
+        success;
+  }
+
+  return success;
+}
+
+/**
+ * @brief Blocks SIGINT and SIGTERM, so they can be read from a descriptor
+ * next to the inotify one
+ *
+ * @return int (-1 on failure)
+ */
+int open_signal_fd() {
+  sigset_t signals;
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGINT);
+  sigaddset(&signals, SIGTERM);
+
+  if (pthread_sigmask(SIG_BLOCK, &signals, nullptr) != 0)
+    return -1;
+
+  return signalfd(-1, &signals, SFD_CLOEXEC);
+}
+} // namespace
+
+/**
+ * @brief Construct a new Watch_Command object
+ *
+ */
+Watch_Command::Watch_Command() {}
+
+/**
+ * @brief Execute watch command (takes no arguments)
+ *
+ * @param flags
+ * @return uint8_t
+ */
+uint8_t Watch_Command::execute(const std::vector<std::string> &,
+                               const Flags &flags) const {
+  int debounce_ms = 0;
+  const std::string_view debounce = flags.value(flag("debounce"));
+
+  if (std::from_chars(debounce.data(), debounce.data() + debounce.size(),
+                      debounce_ms)
+              .ec != std::errc() ||
+      debounce_ms < 0) {
+    logger.error_q("is not a valid debounce time", std::string(debounce));
+    return 1;
+  }
+
+  const bool once = flags.has(flag("once"));
+  const std::filesystem::path index_path(file_index::index_path);
+
+  if (dry_run && !once) {
+    logger.error("watching writes the index as files change, --dry-run only "
+                 "works with --once");
+    return 1;
+  }
+
+  /* Created first, so it doesn't change the root after it was stamped (a
+   * dry run only plans it) */
+  if (!dry_run)
+    directory::create_folders({index_path.parent_path()});
+
+  Watcher watcher;
+
+  if (!once && watcher.fd() < 0) {
+    logger.error("could not start watching (inotify is unavailable)");
+    return 1;
+  }
+
+  if (!watcher.index.add_tree(".")) {
+    logger.error("could not index project");
+    return 1;
+  }
+
+  if (once) {
+    /* Planned like every other write, so --dry-run only prints them */
+    plan->mkdir(index_path.parent_path());
+    plan->replace(index_path).append(plan->keep(watcher.index.text()));
+    plan->replace(Completions_Command::cache_path)
+        .append(plan->keep(watcher.completion_text()));
+
+    logger.success("indexed " + std::to_string(watcher.index.files.size()) +
+                   " files in " +
+                   std::to_string(watcher.index.folders.size()) + " folders");
+    return 0;
+  }
+
+  while (!watcher.watch_new_folders())
+    ;
+
+  watcher.save();
+  logger.custom("watching " + std::to_string(watcher.index.folders.size()) +
+                    " folders (" + std::to_string(watcher.index.files.size()) +
+                    " files), stop with ctrl+c",
+                "watch", "theme");
+  logger.flush_buffer();
+
+  const int signal_fd = open_signal_fd();
+  std::array<pollfd, 2> fds = {{{watcher.fd(), POLLIN, 0},
+                                {signal_fd, POLLIN, 0}}};
+  const std::chrono::milliseconds quiet(debounce_ms);
+  bool running = true;
+
+  while (running) {
+    if (poll(fds.data(), fds.size(), -1) < 0 && errno != EINTR)
+      break;
+
+    running = !(fds[1].revents & POLLIN);
+
+    /* Debounce: a burst is applied once it was quiet for a while */
+    std::vector<Event> events;
+    bool complete = watcher.read_events(events);
+    const Clock::time_point deadline =
+        Clock::now() + quiet * max_debounce_factor;
+
+    while (running && Clock::now() < deadline) {
+      const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+          deadline - Clock::now());
+      const int timeout = static_cast<int>(std::min(quiet, left).count());
+
+      if (poll(fds.data(), fds.size(), timeout) <= 0)
+        break;
+
+      running = !(fds[1].revents & POLLIN);
+      complete = watcher.read_events(events) && complete;
+    }
+
+    size_t changes = watcher.apply(events);
+
+    if (!complete) { // Events were lost, everything is read again
+      watcher.index.remove_tree(".");
+      watcher.index.add_tree(".");
+      changes++;
+    }
+
+    while (!watcher.watch_new_folders())
+      ;
+
+    if (changes == 0)
+      continue;
+
+    if (!watcher.save())
+      logger.error_q("could not be written",
+                     std::string(file_index::index_path));
+
+    logger.custom(std::to_string(changes) + " changes, " +
+                      std::to_string(watcher.index.files.size()) + " files",
+                  "index", "theme");
+    logger.flush_buffer();
+  }
+
+  if (signal_fd >= 0)
+    close(signal_fd);
+
+  return 0;
+}
@@ -0,0 +1,131 @@
+/**
+ * @file cpm.cpp
+ * @brief Gives functionality to cpm.h
+ * @version 0.1
+ * @date 2025-05-25
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#include "../include/cpm.h"
+#include "../include/data.h"
+#include "../include/directory.h"
+#include "../include/file_index.h"
+#include "../include/paths.h"
+#include "../include/vfs.h"
+
+#include "../include/commands/command_manager.h"
+
+#include <vector>
+
+namespace {
+/**
+ * @brief Sets project root, sink and filesystem of the calling thread for
+ * the duration of one run (the state is per thread, so runs on different
+ * threads don't see each other's)
+ *
+ */
+struct Run_Scope {
+  Logger &logger = Logger::get();
+
+  Run_Scope(const cpm::Options &options) {
+    /* Explicit, so IO workers resolve paths against it rather than their own
+     * working directory */
+    paths::set_root(options.root.empty() ? std::filesystem::current_path()
+                                         : options.root);
+    directory::hold_handles(); // Shared with runs on the same root
+    logger.set_sink(options.sink);
+    file_index::forget(); // Files may have changed since the last run
+    directory::forget_extension();
+  }
+
+  ~Run_Scope() {
+    directory::forget_handles(); // Root may be replaced before the next run
+    Vfs::use(nullptr);
+    logger.set_sink(nullptr);
+    paths::set_root({});
+    paths::forget(); // Embedders may change directory before the next run
+  }
+};
+} // namespace
+
+namespace cpm {
+/**
+ * @brief Runs command like the cpm binary would, runs on different threads
+ * may run in parallel as long as they work on different project roots
+ *
+ * @param command Command name
+ * @param arguments Arguments and flags ("-f", "--flag" or "--flag=value",
+ * parsed against the command's schema)
+ * @param options How command is run
+ * @return uint8_t (exit code)
+ */
+uint8_t run(std::string_view command, std::span<const std::string> arguments,
+            const Options &options) {
+  const Run_Scope scope(options);
+  Logger &logger = scope.logger;
+
+  const Command_Entry *entry = Command_Manager::find(command);
+
+  if (!entry) {
+    logger.error_q("command does not exist, try using cpm --help",
+                   std::string(command));
+    return 1;
+  }
+
+  /* Arguments + flags (flags are parsed against the command's schema) */
+  std::vector<std::string> args;
+  Flags flags(entry->flag_schema);
+
+  for (const auto &arg : arguments) {
+    if (arg.size() > 1 && arg[0] == '-') {
+      if (!flags.parse(arg))
+        return 1;
+    } else
+      args.push_back(arg);
+  }
+
+  logger.success("parsed command");
+
+  /* Checks if minimum arguments requirement is met */
+  if (args.size() < entry->min_args) {
+    logger.error_q("requires at least " + std::to_string(entry->min_args) +
+                       " arguments",
+                   std::string(command));
+    return 1;
+  }
+
+  /* Command execution */
+  Command_Manager manager;
+  uint8_t result;
+
+  if (options.in_memory) {
+    /* Reads fall through to disk, writes stay in memory */
+    Memory_Vfs memory_fs(&Vfs::current());
+    Vfs::use(&memory_fs);
+    result = manager.execute(*entry, args, flags, options.dry_run);
+    Vfs::use(nullptr);
+
+    logger.custom(std::to_string(memory_fs.file_count()) + " files",
+                  "in-memory", "theme");
+
+    if (result == 0 && !options.dump_folder.empty() &&
+        !memory_fs.dump(options.dump_folder, Vfs::current())) {
+      logger.error_q("could not be dumped to", options.dump_folder);
+      result = 1;
+    }
+  } else
+    result = manager.execute(*entry, args, flags, options.dry_run);
+
+  /* Saving data (only written if a command modified it, never in memory),
+   * changes that aren't written are dropped so a later run doesn't write
+   * them */
+  if (result == 0 && options.save_config && !options.dry_run &&
+      !options.in_memory)
+    Data_Manager::get().write();
+  else
+    Data_Manager::get().discard();
+
+  return result;
+}
+} // namespace cpm
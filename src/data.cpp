@@ -13,11 +13,19 @@
 
 #include <cstdlib>
 #include <fstream>
+#include <map>
+#include <optional>
+
+namespace {
+/* Config changes of the calling thread's run (std::nullopt for removed
+ * keys), only seen by that run until write applies them */
+thread_local std::map<std::string, std::optional<std::string>, std::less<>>
+    pending;
+} // namespace
 
 #ifdef _WIN32
 /**
- * @brief Ensures existance of valid store location for cpm config data and
- * returns it (WINDOWS ONLY)
+ * @brief Gets store location for cpm config data (WINDOWS ONLY)
  *
  * @return std::string
  */
@@ -26,25 +34,19 @@ std::filesystem::path get_store_location() {
 }
 #else
 /**
- * @brief Ensures existance of valid store location for cpm config data and
- * returns it (NON-WINDOWS)
+ * @brief Gets store location for cpm config data (NON-WINDOWS), the location
+ * is only created once something is written to it
  *
  * @return std::string
  */
 std::filesystem::path get_store_location() {
   /* /Users/<user>/.config/cpm */
-  std::string home_loc = std::getenv("HOME");
-  home_loc += "/.config";
-
-  if (!directory::has_folder(home_loc))
-    directory::create_folders({home_loc});
-
-  home_loc += "/cpm";
+  const char *home = std::getenv("HOME");
 
-  if (!directory::has_folder(home_loc))
-    directory::create_folders({home_loc});
+  if (!home)
+    return {};
 
-  return std::filesystem::absolute(home_loc);
+  return std::filesystem::path(home) / ".config/cpm";
 }
 #endif
 
@@ -59,13 +61,22 @@ Data_Manager &Data_Manager::get() {
 }
 
 /**
- * @brief Reads config file and stores it in data
+ * @brief Reads config file and stores it in data (only once, on first
+ * access, mutex is held by the caller)
  *
  */
 void Data_Manager::read() {
-  std::string config_location = get_store_location();
+  if (loaded)
+    return;
+
+  loaded = true;
 
-  config_location += "/cpm.data";
+  const std::filesystem::path store_location = get_store_location();
+
+  if (store_location.empty())
+    return;
+
+  const std::filesystem::path config_location = store_location / "cpm.data";
 
   if (!directory::has_file(config_location))
     return;
@@ -76,7 +87,7 @@ void Data_Manager::read() {
     return;
 
   /* Reading */
-  char ch, prevCh;
+  char ch, prevCh = '\0';
   std::string key, value;
   bool onKey = true;
 
@@ -90,11 +101,12 @@ void Data_Manager::read() {
 
       prevCh = ch;
       continue;
-    } else if (prevCh == ':') // : = switch from key to value
+    } else if (!onKey && prevCh == ':' &&
+               value.empty()) // : = switch from key to value
     {
       prevCh = ch;
       continue;
-    } else if (ch == ':') // space between colon and value
+    } else if (onKey && ch == ':') // space between colon and value
     {
       onKey = false;
       prevCh = ch;
@@ -116,13 +128,35 @@ void Data_Manager::read() {
 }
 
 /**
- * @brief Writes to config from stored information
+ * @brief Writes the calling thread's config changes to config (only if it
+ * changed something), changes of runs on other threads stay pending
  *
  */
 void Data_Manager::write() {
-  std::string config_location = get_store_location();
+  if (pending.empty())
+    return;
+
+  const std::lock_guard lock(mutex);
+  read();
+
+  for (auto &[key, value] : pending) {
+    if (value)
+      config[key] = std::move(*value);
+    else
+      config.erase(key);
+  }
+
+  pending.clear();
+
+  const std::filesystem::path store_location = get_store_location();
+
+  if (store_location.empty())
+    return;
+
+  if (!directory::has_folder(store_location))
+    directory::create_folders({store_location});
 
-  std::ofstream data_file(config_location + "/cpm.data");
+  std::ofstream data_file(store_location / "cpm.data");
 
   if (!misc::ofstream_open(data_file))
     return;
@@ -138,15 +172,71 @@ void Data_Manager::write() {
 }
 
 /**
- * @brief Checks if config contains key
+ * @brief Drops the calling thread's config changes that weren't written
+ *
+ */
+void Data_Manager::discard() { pending.clear(); }
+
+/**
+ * @brief Checks if config contains key (changes of the calling thread's run
+ * included)
  *
  * @param key Key to check for
  * @return true
  * @return false
  */
 bool Data_Manager::config_has_key(const std::string &key) {
+  if (const auto change = pending.find(key); change != pending.end())
+    return change->second.has_value();
+
+  const std::lock_guard lock(mutex);
+  read();
+
   if (config.find(key) != config.end())
     return true;
 
   return false;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Gets value of key in config (changes of the calling thread's run
+ * included)
+ *
+ * @param key Key to get
+ * @return std::string (empty if key does not exist)
+ */
+std::string Data_Manager::get_value(const std::string &key) {
+  if (const auto change = pending.find(key); change != pending.end())
+    return change->second.value_or("");
+
+  const std::lock_guard lock(mutex);
+  read();
+
+  const auto it = config.find(key);
+
+  if (it == config.end())
+    return "";
+
+  return it->second;
+}
+
+/**
+ * @brief Sets value of key in config (pending until write)
+ *
+ * @param key Key to set
+ * @param value Value to set key to
+ */
+void Data_Manager::set_value(const std::string &key,
+                             const std::string &value) {
+  pending.insert_or_assign(key, value);
+}
+
+/**
+ * @brief Removes key from config (pending until write)
+ *
+ * @param key Key to remove
+ */
+void Data_Manager::remove_value(const std::string &key) {
+  if (config_has_key(key))
+    pending.insert_or_assign(key, std::nullopt);
+}
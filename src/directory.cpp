@@ -8,9 +8,194 @@
  *
  */
 #include "../include/directory.h"
-#include <algorithm>
+#include "../include/emitter.h"
+#include "../include/paths.h"
+#include "../include/vfs.h"
+
+#include <array>
+#include <fcntl.h>
+#include <map>
+#include <mutex>
+#include <unistd.h>
+
+namespace {
+constexpr std::array<std::string_view, 2> handled_folders = {"src",
+                                                             "include"};
+
+/**
+ * @brief O_PATH handles of a project root and its handled folders, opened
+ * once per run so the kernel doesn't walk the whole absolute path for every
+ * operation (shared by the runs on the same root)
+ *
+ */
+struct Handles {
+  std::mutex mutex;
+  std::string root_path; // Absolute and normalized
+  int root = -1;
+  std::array<int, handled_folders.size()> folders{-1, -1};
+  size_t users = 0; // Runs holding them
+};
+
+std::map<std::string, Handles, std::less<>> roots; // By root_path
+std::mutex roots_mutex;
+
+/**
+ * @brief Checks if target is root or inside it
+ *
+ * @param target Absolute and normalized path
+ * @param root Absolute and normalized directory
+ * @return true
+ * @return false
+ */
+bool inside(std::string_view target, std::string_view root) {
+  if (!target.starts_with(root))
+    return false;
+
+  target.remove_prefix(root.size());
+
+  /* Not a sibling sharing a name prefix */
+  return target.empty() || target.front() == '/' || root.ends_with('/');
+}
+
+/**
+ * @brief Gets handles of the project root set on the calling thread (never
+ * the working directory a thread without a root falls back to)
+ *
+ * @return Handles* (nullptr if no root is set or no run holds its handles,
+ * stays valid while the run holding them goes on)
+ */
+Handles *handles() {
+  if (!paths::has_root())
+    return nullptr;
+
+  const std::lock_guard lock(roots_mutex);
+  const auto it = roots.find(paths::root());
+
+  return (it != roots.end()) ? &it->second : nullptr;
+}
+
+/**
+ * @brief Opens directory as an O_PATH handle
+ *
+ * @param dirfd Directory to open relative to
+ * @param path Path to directory
+ * @return int (-1 if it doesn't exist)
+ */
+int open_handle(int dirfd, const char *path) {
+  return openat(dirfd, path, O_PATH | O_DIRECTORY | O_CLOEXEC);
+}
+
+/**
+ * @brief Extension get_extension found for a project root, kept until files
+ * are written or the next run starts (commands ask once per name)
+ *
+ */
+struct Extension_Cache {
+  std::string root;
+  std::string extension;
+};
+
+thread_local Extension_Cache extension_cache;
+} // namespace
 
 namespace directory {
+/**
+ * @brief Resolves path to the deepest open handle of the calling thread's
+ * project root containing it (a handle that doesn't exist yet is retried on
+ * the next call, paths outside the project root and paths resolved without
+ * held handles stay absolute)
+ *
+ * @param path Path
+ * @return At_Path
+ */
+At_Path at(const std::filesystem::path &path) {
+  const std::string &target = paths::absolute(path);
+  Handles *const held = handles();
+
+  if (held == nullptr)
+    return {AT_FDCWD, target.c_str()};
+
+  Handles &state = *held;
+  const std::lock_guard lock(state.mutex);
+
+  if (state.root < 0)
+    state.root = open_handle(AT_FDCWD, state.root_path.c_str());
+
+  /* Inside root: "<root>/rest" (the root itself is ".") */
+  std::string_view rest(target);
+
+  if (state.root < 0 || !inside(rest, state.root_path))
+    return {AT_FDCWD, target.c_str()};
+
+  rest.remove_prefix(state.root_path.size());
+
+  while (rest.starts_with('/'))
+    rest.remove_prefix(1);
+
+  if (rest.empty())
+    return {state.root, "."};
+
+  for (size_t i = 0; i < handled_folders.size(); i++) {
+    const std::string_view folder = handled_folders[i];
+
+    if (!rest.starts_with(folder) || rest.size() <= folder.size() + 1 ||
+        rest[folder.size()] != '/')
+      continue;
+
+    if (state.folders[i] < 0)
+      state.folders[i] = open_handle(state.root, folder.data());
+
+    if (state.folders[i] >= 0)
+      return {state.folders[i], rest.data() + folder.size() + 1};
+  }
+
+  return {state.root, rest.data()};
+}
+
+/**
+ * @brief Holds the handles of the calling thread's project root for a run,
+ * at resolves paths through them until forget_handles is called
+ *
+ */
+void hold_handles() {
+  if (!paths::has_root())
+    return;
+
+  const std::lock_guard lock(roots_mutex);
+  auto [state, inserted] = roots.try_emplace(paths::root());
+
+  if (inserted)
+    state->second.root_path = state->first;
+
+  state->second.users++;
+}
+
+/**
+ * @brief Releases the handles hold_handles held, they are closed once no
+ * run holds them, so the next run opens them again (the folders may have
+ * been replaced in between)
+ *
+ */
+void forget_handles() {
+  if (!paths::has_root())
+    return;
+
+  const std::lock_guard lock(roots_mutex);
+  const auto state = roots.find(paths::root());
+
+  if (state == roots.end() || --state->second.users > 0)
+    return;
+
+  if (state->second.root >= 0)
+    close(state->second.root);
+
+  for (const int folder : state->second.folders)
+    if (folder >= 0)
+      close(folder);
+
+  roots.erase(state);
+}
+
 /**
  * @brief Checks if directory exists at path
  *
@@ -19,7 +204,7 @@ namespace directory {
  * @return false
  */
 bool has_folder(const std::filesystem::path &path) {
-  return std::filesystem::is_directory(std::filesystem::absolute(path));
+  return Vfs::current().is_folder(path);
 }
 
 /**
@@ -30,30 +215,26 @@ bool has_folder(const std::filesystem::path &path) {
  * @return false
  */
 bool has_file(const std::filesystem::path &path) {
-  return std::filesystem::exists(std::filesystem::absolute(path));
+  return Vfs::current().exists(path);
 }
 
 /**
- * @brief Creates folder at path for multiple paths
+ * @brief Creates folder at path for multiple paths (and their parents)
  *
  * @param paths Paths to folders to be created
  */
 void create_folders(const std::vector<std::filesystem::path> &paths) {
   for (const auto &path : paths)
-    std::filesystem::create_directories(std::filesystem::absolute(path));
+    Vfs::current().make_folders(path);
 }
 
 /**
- * @brief Create a file at path
+ * @brief Create a file at path (existing contents are kept)
  *
  * @param path Path to file to be created
  */
 void create_file(const std::filesystem::path &path) {
-  if (has_file(path))
-    return;
-
-  std::ofstream file(path);
-  file.close();
+  Vfs::current().write(path, Emitter(), true);
 }
 
 /**
@@ -62,10 +243,125 @@ void create_file(const std::filesystem::path &path) {
  * @param path Path to file to destroy.
  */
 void destroy_file(const std::filesystem::path &path) {
-  if (!has_file(path))
-    return;
+  Vfs::current().remove(path);
+}
+
+/**
+ * @brief Lists every file under folder in one walk (hidden directories and
+ * the top-level build directory are skipped)
+ *
+ * @param folder Folder to list
+ * @param memory Memory resource for listed paths
+ * @return std::pmr::vector<std::pmr::string> (paths relative to folder,
+ * separated by '/')
+ */
+std::pmr::vector<std::pmr::string>
+list_files(const std::filesystem::path &folder,
+           std::pmr::memory_resource *memory) {
+  std::pmr::vector<std::pmr::string> files(memory);
+
+  Vfs::current().list(folder, true, [&](std::string_view relative_path) {
+    files.emplace_back(relative_path);
+  });
+
+  return files;
+}
+
+/**
+ * @brief Lists the files fpair pairs can be in: files directly in the project
+ * root and every file under src/ and include/
+ *
+ * @param memory Memory resource for listed paths
+ * @return std::pmr::vector<std::pmr::string> (paths relative to project
+ * root, separated by '/')
+ */
+std::pmr::vector<std::pmr::string>
+list_pair_files(std::pmr::memory_resource *memory) {
+  std::pmr::vector<std::pmr::string> files(memory);
 
-  std::filesystem::remove(std::filesystem::absolute(path));
+  Vfs::current().list(".", false, [&](std::string_view relative_path) {
+    files.emplace_back(relative_path);
+  });
+
+  for (const std::string_view folder : handled_folders)
+    Vfs::current().list(folder, true, [&](std::string_view relative_path) {
+      files.emplace_back(folder).append("/").append(relative_path);
+    });
+
+  return files;
+}
+
+/**
+ * @brief Checks if listing skips directory (hidden directories and the
+ * top-level build directory)
+ *
+ * @param name Name of directory
+ * @param depth Depth below listed folder (0 for its entries)
+ * @return true
+ * @return false
+ */
+bool skipped_folder(std::string_view name, size_t depth) {
+  return name.starts_with('.') || (depth == 0 && name == "build");
+}
+
+/**
+ * @brief Checks if relative path is listed (see skipped_folder)
+ *
+ * @param relative_path Path relative to listed folder
+ * @param recursive Files in sub-directories are listed
+ * @return true
+ * @return false
+ */
+bool listed(std::string_view relative_path, const bool &recursive) {
+  const size_t last = relative_path.find_last_of('/');
+
+  if (last == std::string_view::npos)
+    return true;
+
+  if (!recursive)
+    return false;
+
+  size_t depth = 0;
+
+  for (const auto &segment :
+       paths::Segments{relative_path.substr(0, last)})
+    if (skipped_folder(segment, depth++))
+      return false;
+
+  return true;
+}
+
+/**
+ * @brief Splits listed project file into its pair name (path without
+ * extension) and structured pair name (a header in include/ or source in
+ * src/ without its folder, like the paths fpair create uses)
+ *
+ * @param file Path relative to project root
+ * @param name Pair name
+ * @param structured_name Structured pair name
+ * @return true if file is a header or source
+ * @return false
+ */
+bool split_pair_path(std::string_view file, std::string_view &name,
+                     std::string_view &structured_name) {
+  const size_t extension_pos = file.find_last_of("./");
+
+  if (extension_pos == std::string_view::npos || file[extension_pos] != '.')
+    return false;
+
+  const std::string_view extension = file.substr(extension_pos);
+  structured_name = name = file.substr(0, extension_pos);
+
+  if (extension == ".h" || extension == ".hpp") {
+    if (name.starts_with("include/"))
+      structured_name.remove_prefix(std::string_view("include/").size());
+  } else if (extension == ".c" || extension == ".cpp") {
+    if (name.starts_with("src/"))
+      structured_name.remove_prefix(std::string_view("src/").size());
+  } else
+    return false;
+
+  return true;
 }
 
 /**
@@ -81,35 +377,36 @@ std::string get_structure() {
 }
 
 /**
- * @brief Get the file extension of directory
+ * @brief Get the file extension of directory (looked up once until files
+ * are written)
  *
  * @return std::string
  */
 std::string get_extension() {
-  /* Get file names */
-  std::vector<std::string> files;
+  if (!extension_cache.extension.empty() &&
+      extension_cache.root == paths::root())
+    return extension_cache.extension;
+
   const std::filesystem::path current_dir(
       (get_structure() == "executable") ? "src/" : "./");
-  const std::filesystem::directory_iterator start(current_dir);
-  const std::filesystem::directory_iterator end;
-
-  std::transform(start, end, std::back_inserter(files),
-                 [](const std::filesystem::directory_entry &entry) {
-                   return entry.path().string();
-                 });
+  bool has_cpp = false;
 
   /* Check for file extentions */
-  for (const auto &v : files) {
-    auto const pos = v.find_last_of(".");
-    const std::string leaf = v.substr(pos + 1);
-
-    if (leaf == "cpp")
-      return ".cpp";
-  }
+  Vfs::current().list(current_dir, false, [&](std::string_view name) {
+    has_cpp = has_cpp || name.ends_with(".cpp");
+  });
 
-  return ".c";
+  extension_cache = {paths::root(), has_cpp ? ".cpp" : ".c"};
+  return extension_cache.extension;
 }
 
+/**
+ * @brief Drops the extension get_extension found, so it looks again (after
+ * files were written)
+ *
+ */
+void forget_extension() { extension_cache = {}; }
+
 /**
  * @brief Gets expected path to header file <name> in directory
  *
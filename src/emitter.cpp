@@ -0,0 +1,199 @@
+/**
+ * @file emitter.cpp
+ * @brief Gives functionality to emitter.h
+ * @version 0.1
+ * @date 2025-03-23
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#include "../include/emitter.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <climits>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace {
+/* Fragments per writev call, generated files usually fit in one batch */
+constexpr size_t iov_batch_size = std::min(128, IOV_MAX);
+} // namespace
+
+/**
+ * @brief Construct a new Emitter object
+ *
+ * @param memory Memory resource for fragment list
+ */
+Emitter::Emitter(std::pmr::memory_resource *memory) : fragments(memory) {}
+
+/**
+ * @brief Appends fragment (the viewed text must outlive the emitter)
+ *
+ * @param fragment Fragment
+ * @return Emitter&
+ */
+Emitter &Emitter::append(std::string_view fragment) {
+  if (fragment.empty())
+    return *this;
+
+  fragments.push_back(fragment);
+  total_size += fragment.size();
+
+  return *this;
+}
+
+/**
+ * @brief Appends every part as its own fragment
+ *
+ * @param parts Parts
+ * @return Emitter&
+ */
+Emitter &Emitter::append(std::initializer_list<std::string_view> parts) {
+  for (const auto &part : parts)
+    append(part);
+
+  return *this;
+}
+
+/**
+ * @brief Appends parts followed by a newline
+ *
+ * @param parts Parts
+ * @return Emitter&
+ */
+Emitter &Emitter::line(std::initializer_list<std::string_view> parts) {
+  return append(parts).append("\n");
+}
+
+/**
+ * @brief Appends a newline followed by parts (the format File::write uses when
+ * appending to existing contents)
+ *
+ * @param parts Parts
+ * @return Emitter&
+ */
+Emitter &
+Emitter::appended_line(std::initializer_list<std::string_view> parts) {
+  return append("\n").append(parts);
+}
+
+/**
+ * @brief Reserves space for count more fragments
+ *
+ * @param count Number of fragments
+ */
+void Emitter::reserve(size_t count) {
+  const size_t needed = fragments.size() + count;
+
+  if (needed > fragments.capacity())
+    fragments.reserve(std::max(needed, fragments.capacity() * 2));
+}
+
+/**
+ * @brief Gets total size of emitted content in bytes
+ *
+ * @return size_t
+ */
+size_t Emitter::size() const { return total_size; }
+
+/**
+ * @brief Gets emitted fragments in order
+ *
+ * @return std::span<const std::string_view>
+ */
+std::span<const std::string_view> Emitter::get_fragments() const {
+  return fragments;
+}
+
+/**
+ * @brief Appends all fragments to string
+ *
+ * @param out String to append to
+ */
+void Emitter::render(std::string &out) const {
+  out.reserve(out.size() + total_size);
+
+  for (const auto &fragment : fragments)
+    out += fragment;
+}
+
+/**
+ * @brief Writes all fragments to file with writev (one call per
+ * iov_batch_size fragments)
+ *
+ * @param path Path to file
+ * @param append Append to file instead of overwriting it
+ * @return true
+ * @return false
+ */
+bool Emitter::write_to(const std::filesystem::path &path,
+                       const bool &append) const {
+  return write_to(AT_FDCWD, path.c_str(), append);
+}
+
+/**
+ * @brief Writes all fragments to file relative to an open directory
+ *
+ * @param dirfd Directory handle (or AT_FDCWD)
+ * @param path Path to file relative to dirfd
+ * @param append Append to file instead of overwriting it
+ * @return true
+ * @return false
+ */
+bool Emitter::write_to(int dirfd, const char *path, const bool &append) const {
+  const int flags =
+      O_WRONLY | O_CREAT | O_CLOEXEC | (append ? O_APPEND : O_TRUNC);
+  const int fd = openat(dirfd, path, flags, 0644);
+
+  if (fd < 0)
+    return false;
+
+  std::array<iovec, iov_batch_size> iov;
+  size_t next = 0;
+  bool ok = true;
+
+  while (ok && next < fragments.size()) {
+    /* Fill batch */
+    const size_t count = std::min(fragments.size() - next, iov.size());
+
+    for (size_t i = 0; i < count; i++)
+      iov[i] = {const_cast<char *>(fragments[next + i].data()),
+                fragments[next + i].size()};
+
+    next += count;
+
+    /* Write batch, resuming after partial writes */
+    iovec *it = iov.data();
+    size_t left = count;
+
+    while (left > 0) {
+      const ssize_t written = writev(fd, it, static_cast<int>(left));
+
+      if (written < 0) {
+        if (errno == EINTR)
+          continue;
+
+        ok = false;
+        break;
+      }
+
+      size_t n = static_cast<size_t>(written);
+
+      while (left > 0 && n >= it->iov_len) {
+        n -= it->iov_len;
+        it++;
+        left--;
+      }
+
+      if (left > 0) {
+        it->iov_base = static_cast<char *>(it->iov_base) + n;
+        it->iov_len -= n;
+      }
+    }
+  }
+
+  return (close(fd) == 0) && ok;
+}
\ No newline at end of file
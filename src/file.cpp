@@ -9,7 +9,23 @@
  */
 
 #include "../include/file.h"
+#include "../include/directory.h"
+#include "../include/logger.h"
 #include "../include/misc.h"
+#include "../include/paths.h"
+#include "../include/vfs.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+
+namespace {
+/* Fragment list of a plain line write fits on the stack */
+constexpr size_t fragment_buffer_size = 1024;
+
+Logger &logger = Logger::get();
+} // namespace
 
 /**
  * @brief Construct a new File:: File object
@@ -17,21 +33,26 @@
  * @param _path
  */
 File::File(const std::filesystem::path &_path)
-    : path(std::filesystem::absolute(_path)) {
-  std::filesystem::create_directories(
-      std::filesystem::absolute(path.parent_path()));
-
-  writer.open(path, std::ios::app);
-  writer.close();
+    : path(paths::absolute(_path)) {
+  directory::create_folders({path.parent_path()});
+  directory::create_file(path);
 }
 
 /**
- * @brief Destroy the File:: File object
+ * @brief Writes (in append mode) lines to file
  *
+ * @param lines Lines to write
  */
-File::~File() {
-  writer.close();
-  reader.close();
+void File::write(std::span<const std::string_view> lines) {
+  std::array<std::byte, fragment_buffer_size> buffer;
+  std::pmr::monotonic_buffer_resource memory(buffer.data(), buffer.size());
+  Emitter emitter(&memory);
+  emitter.reserve(lines.size() * 2);
+
+  for (const auto &line : lines)
+    emitter.appended_line({line});
+
+  write(emitter);
 }
 
 /**
@@ -39,16 +60,18 @@ File::~File() {
  *
  * @param lines Lines to write
  */
-void File::write(const std::vector<std::string> &lines) {
-  writer.open(path, std::ios::app);
-
-  if (!misc::ofstream_open(writer))
-    return;
-
-  for (const auto &line : lines)
-    writer << "\n" << line;
+void File::write(std::initializer_list<std::string_view> lines) {
+  write(std::span(lines.begin(), lines.size()));
+}
 
-  writer.close();
+/**
+ * @brief Writes (in append mode) emitted fragments to file
+ *
+ * @param emitter Emitter
+ */
+void File::write(const Emitter &emitter) {
+  if (!Vfs::current().write(path, emitter, true))
+    logger.custom("failed to write file", "writev", "error");
 }
 
 /**
@@ -56,91 +79,94 @@ void File::write(const std::vector<std::string> &lines) {
  *
  * @param lines Lines to write
  */
-void File::load(const std::vector<std::string> &lines) {
-  writer.open(path);
-
-  if (!misc::ofstream_open(writer))
-    return;
+void File::load(std::span<const std::string_view> lines) {
+  std::array<std::byte, fragment_buffer_size> buffer;
+  std::pmr::monotonic_buffer_resource memory(buffer.data(), buffer.size());
+  Emitter emitter(&memory);
+  emitter.reserve(lines.size() * 2);
 
   for (const auto &line : lines)
-    writer << line << "\n";
+    emitter.line({line});
 
-  writer.close();
+  load(emitter);
 }
 
 /**
- * @brief Removes file from computer
+ * @brief Overwrites file with given lines
  *
+ * @param lines Lines to write
  */
-void File::remove() {
-  writer.close();
-  reader.close();
+void File::load(std::initializer_list<std::string_view> lines) {
+  load(std::span(lines.begin(), lines.size()));
+}
 
-  std::filesystem::remove(path);
+/**
+ * @brief Overwrites file with emitted fragments
+ *
+ * @param emitter Emitter
+ */
+void File::load(const Emitter &emitter) {
+  if (!Vfs::current().write(path, emitter, false))
+    logger.custom("failed to write file", "writev", "error");
 }
 
+/**
+ * @brief Removes file from computer
+ *
+ */
+void File::remove() { directory::destroy_file(path); }
+
 /**
  * @brief Reads file into vector containing individual lines
  *
  * @return std::vector<std::string>
  */
 std::vector<std::string> File::read() {
-  reader.open(path);
+  std::string text;
 
-  if (!misc::ifstream_open(reader))
+  if (!Vfs::current().read(path, text)) {
+    logger.custom("failed to open file", "read", "error");
     return {};
+  }
 
   std::vector<std::string> lines;
-  std::string line;
 
-  while (std::getline(reader, line))
-    lines.emplace_back(line);
+  for (size_t start = 0; start < text.size();) {
+    const size_t end = std::min(text.find('\n', start), text.size());
+    lines.emplace_back(text, start, end - start);
+    start = end + 1;
+  }
 
   return lines;
 }
 
 /**
  * @brief Finds first instance of 'token_f' in file and replaces it with
- * 'token_r'
+ * 'token_r' (the file is rewritten line by line)
  *
  * @param token_f Text to find
  * @param token_r Text to replace with
  */
 void File::replace_first_with(const std::string &token_f,
                               const std::string &token_r) {
-  const std::filesystem::path tmp_path(path.string() + ".tmp");
-
-  writer.open(tmp_path);
-  reader.open(path);
+  std::vector<std::string> lines = read();
+  Emitter emitter;
+  emitter.reserve(lines.size() * 2);
 
-  if (!misc::ifstream_open(reader) | !misc::ofstream_open(writer))
-    return;
+  for (auto &line : lines) {
+    const size_t pos = line.find(token_f);
 
-  std::string line;
-  size_t pos;
-  bool searching = true;
-
-  while (std::getline(reader, line)) {
-    if (searching && (pos = line.find(token_f)) !=
-                         std::string::npos) // Replcae first instance of token_f
-                                            // with token_r
-    {
+    if (pos != std::string::npos) {
       line.replace(pos, token_f.length(), token_r);
-      searching = false; // Switch off searching mode
+      break;
     }
-
-    writer << line << "\n";
   }
 
-  writer.close();
-  reader.close();
-
-  // Delete original file
-  if (!std::filesystem::remove(path))
-    return;
+  for (const auto &line : lines)
+    emitter.line({line});
 
-  /* Change temporary file into original file */
-  std::filesystem::rename(tmp_path, path);
+  if (!Vfs::current().replace(path, emitter))
+    logger.custom("failed to write file", "rename", "error");
 }
 
 /**
@@ -151,28 +177,9 @@ void File::replace_first_with(const std::string &token_f,
  * @return false
  */
 bool File::exists(const std::string &token_f) {
-  reader.open(path);
-
-  std::string current_token;
-  char ch;
-
-  while (reader.get(ch)) {
-    if (ch == ' ' | ch == '\n') {
-      current_token = "";
-      continue;
-    }
-
-    std::string _ch(1, ch);
-    current_token += _ch;
+  std::string text;
 
-    if (current_token == token_f) {
-      reader.close();
-      return true;
-    }
-  }
-
-  reader.close();
-  return false;
+  return Vfs::current().read(path, text) && misc::has_token(text, token_f);
 }
 
 /**
@@ -201,7 +208,4 @@ char File::compare(const File &_f) const {
  */
 std::filesystem::path File::trim(const File &_f) const {
   return misc::trim_path(path, _f.get_path());
-}
-
-std::ofstream File::writer;
-std::ifstream File::reader;
\ No newline at end of file
+}
\ No newline at end of file
@@ -0,0 +1,329 @@
+/**
+ * @file file_index.cpp
+ * @brief Index of project files, checked against the modification times of
+ * its folders instead of walking them again
+ * @version 0.1
+ * @date 2025-06-08
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#include "../include/file_index.h"
+#include "../include/directory.h"
+#include "../include/emitter.h"
+#include "../include/paths.h"
+#include "../include/tree_walker.h"
+#include "../include/vfs.h"
+
+#include <charconv>
+#include <fcntl.h>
+#include <mutex>
+#include <optional>
+#include <sys/stat.h>
+
+namespace {
+constexpr std::string_view index_header = "cpm index 1";
+
+/**
+ * @brief Gets modification time of folder
+ *
+ * @param folder Path relative to project root
+ * @return std::optional<file_index::Stamp> (empty if it isn't a folder)
+ */
+std::optional<file_index::Stamp> folder_stamp(std::string_view folder) {
+  const directory::At_Path target =
+      directory::at(std::filesystem::path(folder));
+  struct stat info;
+
+  if (fstatat(target.dirfd, target.path, &info, 0) != 0 ||
+      !S_ISDIR(info.st_mode))
+    return std::nullopt;
+
+  return file_index::Stamp{info.st_mtim.tv_sec, info.st_mtim.tv_nsec};
+}
+
+/**
+ * @brief Parses integer at the start of text and the space after it
+ *
+ * @param text Text (advanced past the integer)
+ * @param value Parsed integer
+ * @return true
+ * @return false
+ */
+bool parse_field(std::string_view &text, int64_t &value) {
+  const auto [end, error] =
+      std::from_chars(text.data(), text.data() + text.size(), value);
+
+  if (error != std::errc() || end == text.data() + text.size() ||
+      *end != ' ')
+    return false;
+
+  text.remove_prefix(end - text.data() + 1);
+  return true;
+}
+
+/**
+ * @brief Loaded indexes by project root
+ *
+ */
+struct Cache {
+  std::mutex mutex;
+  std::map<std::string, std::optional<file_index::Index>, std::less<>> roots;
+};
+
+Cache &indexes() {
+  static Cache instance;
+  return instance;
+}
+} // namespace
+
+namespace file_index {
+/**
+ * @brief Adds folder and everything below it, each folder is stamped before
+ * it is read (a change while it is read makes the index stale, not wrong)
+ *
+ * @param folder Path relative to project root ("." for root)
+ * @return true
+ * @return false
+ */
+bool Index::add_tree(std::string_view folder) {
+  const std::string prefix = (folder == ".") ? "" : std::string(folder) + "/";
+
+  Walk_Options options;
+  options.folders = true;
+
+  return Tree_Walker(options).walk(
+      std::filesystem::path(folder), [&](const Walk_Entry &entry) {
+        if (!entry.folder)
+          files.insert(prefix + entry.path);
+        else
+          folders.insert_or_assign(
+              entry.path.empty() ? std::string(folder) : prefix + entry.path,
+              Stamp{entry.modified.tv_sec, entry.modified.tv_nsec});
+
+        return true;
+      });
+}
+
+/**
+ * @brief Removes folder and everything below it
+ *
+ * @param folder Path relative to project root ("." for root)
+ */
+void Index::remove_tree(std::string_view folder) {
+  if (folder == ".") {
+    files.clear();
+    folders.clear();
+    return;
+  }
+
+  const std::string prefix = std::string(folder) + "/";
+
+  if (const auto it = folders.find(folder); it != folders.end())
+    folders.erase(it);
+
+  for (auto it = folders.lower_bound(prefix);
+       it != folders.end() && it->first.starts_with(prefix);)
+    it = folders.erase(it);
+
+  for (auto it = files.lower_bound(prefix);
+       it != files.end() && it->starts_with(prefix);)
+    it = files.erase(it);
+}
+
+/**
+ * @brief Records current modification time of folder
+ *
+ * @param folder Path relative to project root ("." for root)
+ * @return true
+ * @return false if it isn't a folder (anymore)
+ */
+bool Index::stamp(std::string_view folder) {
+  const std::optional<Stamp> stamp = folder_stamp(folder);
+
+  if (!stamp)
+    return false;
+
+  folders.insert_or_assign(std::string(folder), *stamp);
+  return true;
+}
+
+/**
+ * @brief Checks if no file was added to or removed from any indexed folder
+ * since it was stamped (one stat per folder, no folder is read)
+ *
+ * @return true
+ * @return false
+ */
+bool Index::fresh() const {
+  if (folders.empty())
+    return false;
+
+  for (const auto &[folder, stamp] : folders)
+    if (folder_stamp(folder) != stamp)
+      return false;
+
+  return true;
+}
+
+/**
+ * @brief Gets contents of the index file
+ *
+ * @return std::string
+ */
+std::string Index::text() const {
+  std::string text(index_header);
+  text += '\n';
+
+  for (const auto &[folder, stamp] : folders)
+    text += "d " + std::to_string(stamp.seconds) + " " +
+            std::to_string(stamp.nanoseconds) + " " + folder + "\n";
+
+  for (const auto &file : files)
+    if (file.find('\n') == std::string::npos)
+      text += "f " + file + "\n";
+
+  return text;
+}
+
+/**
+ * @brief Writes index to its file (renamed into place, readers never see
+ * half of it)
+ *
+ * @return true
+ * @return false
+ */
+bool Index::save() const {
+  const std::string contents = text();
+  Emitter content;
+  content.append(contents);
+
+  Vfs &vfs = Vfs::current();
+  return vfs.make_folders(paths::parent(index_path)) &&
+         vfs.replace(index_path, content);
+}
+
+/**
+ * @brief Reads index from its file
+ *
+ * @return true
+ * @return false if there is none or it isn't readable
+ */
+bool Index::load() {
+  std::string text;
+
+  if (!Vfs::current().read(index_path, text))
+    return false;
+
+  std::string_view rest(text);
+  const size_t header_end = rest.find('\n');
+
+  if (header_end == std::string_view::npos ||
+      rest.substr(0, header_end) != index_header)
+    return false;
+
+  rest.remove_prefix(header_end + 1);
+
+  while (!rest.empty()) {
+    const size_t end = rest.find('\n');
+
+    if (end == std::string_view::npos)
+      return false; // Cut short
+
+    std::string_view line = rest.substr(0, end);
+    rest.remove_prefix(end + 1);
+
+    if (line.starts_with("f ")) {
+      files.emplace_hint(files.end(), line.substr(2));
+      continue;
+    }
+
+    if (!line.starts_with("d "))
+      return false;
+
+    Stamp stamp;
+    line.remove_prefix(2);
+
+    if (!parse_field(line, stamp.seconds) ||
+        !parse_field(line, stamp.nanoseconds))
+      return false;
+
+    folders.emplace_hint(folders.end(), line, stamp);
+  }
+
+  return true;
+}
+
+/**
+ * @brief Gets index of the calling thread's project root if it is fresh,
+ * loaded once and kept until forget is called
+ *
+ * @return const Index* (nullptr if there is no fresh index)
+ */
+const Index *current() {
+  Cache &cache = indexes();
+  const std::lock_guard lock(cache.mutex);
+  auto [it, inserted] = cache.roots.try_emplace(paths::root());
+
+  if (inserted) {
+    Index index;
+
+    if (index.load() && index.fresh())
+      it->second = std::move(index);
+  }
+
+  return it->second ? &*it->second : nullptr;
+}
+
+/**
+ * @brief Drops index of the calling thread's project root, so the next
+ * listing checks it again (after files were written or removed)
+ *
+ */
+void forget() {
+  Cache &cache = indexes();
+  const std::lock_guard lock(cache.mutex);
+  const auto it = cache.roots.find(paths::root());
+
+  if (it != cache.roots.end())
+    cache.roots.erase(it);
+}
+
+/**
+ * @brief Lists files in folder from the index, in the order and with the
+ * same folders skipped as a walk of the folder would
+ *
+ * @param folder Folder to list
+ * @param recursive List files in sub-directories too
+ * @param on_file Called with path of every file relative to folder
+ * @return true
+ * @return false if folder isn't indexed or there is no fresh index (folder
+ * must be walked)
+ */
+bool list(const std::filesystem::path &folder, const bool &recursive,
+          const std::function<void(std::string_view)> &on_file) {
+  const Index *index = current();
+
+  if (index == nullptr)
+    return false;
+
+  const std::optional<std::string_view> relative = paths::root_relative(folder);
+
+  if (!relative ||
+      !index->folders.contains(relative->empty() ? "." : *relative))
+    return false;
+
+  const std::string prefix =
+      relative->empty() ? "" : std::string(*relative) + "/";
+
+  for (auto it = index->files.lower_bound(prefix);
+       it != index->files.end() && it->starts_with(prefix); ++it) {
+    const std::string_view path = std::string_view(*it).substr(prefix.size());
+
+    if (directory::listed(path, recursive))
+      on_file(path);
+  }
+
+  return true;
+}
+} // namespace file_index
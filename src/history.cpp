@@ -0,0 +1,215 @@
+/**
+ * @file history.cpp
+ * @brief Keeps timing history of cpm runs in a fixed-size ring buffer file
+ * @version 0.1
+ * @date 2025-06-01
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#include "../include/history.h"
+#include "../include/data.h"
+#include "../include/directory.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <string>
+#include <sys/file.h>
+#include <unistd.h>
+
+namespace {
+constexpr std::array<char, 8> magic = {'c', 'p', 'm', 'h', 'i', 's', 't', '1'};
+
+/**
+ * @brief Start of history file, capacity records follow it
+ *
+ */
+struct Header {
+  std::array<char, 8> magic;
+  uint32_t capacity;
+  uint32_t next;  // Slot the next record is written to
+  uint64_t total; // Runs recorded since the file was created
+};
+
+/**
+ * @brief Checks if header belongs to a history file of this layout
+ *
+ * @param header Header
+ * @return true
+ * @return false
+ */
+bool valid(const Header &header) {
+  return header.magic == magic && header.capacity == history::capacity &&
+         header.next < history::capacity;
+}
+
+/**
+ * @brief Reads exactly size bytes at offset
+ *
+ * @param fd File descriptor
+ * @param data Buffer
+ * @param size Number of bytes
+ * @param offset Offset in file
+ * @return true
+ * @return false
+ */
+bool read_at(int fd, void *data, size_t size, off_t offset) {
+  return pread(fd, data, size, offset) == static_cast<ssize_t>(size);
+}
+
+/**
+ * @brief Writes exactly size bytes at offset
+ *
+ * @param fd File descriptor
+ * @param data Buffer
+ * @param size Number of bytes
+ * @param offset Offset in file
+ * @return true
+ * @return false
+ */
+bool write_at(int fd, const void *data, size_t size, off_t offset) {
+  return pwrite(fd, data, size, offset) == static_cast<ssize_t>(size);
+}
+} // namespace
+
+namespace history {
+/**
+ * @brief Sets command name (cut to fit)
+ *
+ * @param name Command name
+ */
+void Record::set_command(std::string_view name) {
+  const size_t size = std::min(name.size(), sizeof(command) - 1);
+
+  std::memcpy(command, name.data(), size);
+  command[size] = '\0';
+}
+
+/**
+ * @brief Gets command name
+ *
+ * @return std::string_view (view into record)
+ */
+std::string_view Record::get_command() const {
+  return {command, strnlen(command, sizeof(command))};
+}
+
+/**
+ * @brief Gets location of history file
+ *
+ * @return std::filesystem::path (empty if there is no store location)
+ */
+std::filesystem::path location() {
+  const std::filesystem::path store_location = get_store_location();
+
+  if (store_location.empty())
+    return {};
+
+  return store_location / "history";
+}
+
+/**
+ * @brief Fills I/O counts of record with those of the running process so far
+ * (left at zero where /proc/self/io isn't available)
+ *
+ * @param record Record
+ */
+void count_io(Record &record) {
+  std::ifstream io("/proc/self/io");
+  std::string key;
+  uint64_t value;
+
+  while (io >> key >> value) {
+    if (key == "rchar:")
+      record.read_bytes = value;
+    else if (key == "wchar:")
+      record.write_bytes = value;
+    else if (key == "syscr:")
+      record.read_calls = value;
+    else if (key == "syscw:")
+      record.write_calls = value;
+  }
+}
+
+/**
+ * @brief Writes record over the oldest one once the file is full (a file of
+ * another layout is started over), runs of other processes wait for the lock
+ *
+ * @param record Record
+ * @return true
+ * @return false
+ */
+bool append(const Record &record) {
+  const std::filesystem::path path = location();
+
+  if (path.empty())
+    return false;
+
+  if (!directory::has_folder(path.parent_path()))
+    directory::create_folders({path.parent_path()});
+
+  const int fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+
+  if (fd < 0)
+    return false;
+
+  flock(fd, LOCK_EX);
+
+  Header header;
+
+  if (!read_at(fd, &header, sizeof(header), 0) || !valid(header))
+    header = {magic, capacity, 0, 0};
+
+  bool success =
+      write_at(fd, &record, sizeof(record),
+               sizeof(Header) + static_cast<off_t>(header.next) *
+                                    static_cast<off_t>(sizeof(Record)));
+
+  if (success) {
+    header.next = (header.next + 1) % capacity;
+    header.total++;
+    success = write_at(fd, &header, sizeof(header), 0);
+  }
+
+  close(fd); // Releases lock
+  return success;
+}
+
+/**
+ * @brief Reads every record in history
+ *
+ * @return std::vector<Record> (oldest first, empty if there is no history)
+ */
+std::vector<Record> read() {
+  std::vector<Record> records;
+  const std::filesystem::path path = location();
+
+  if (path.empty())
+    return records;
+
+  const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+  if (fd < 0)
+    return records;
+
+  flock(fd, LOCK_SH);
+
+  Header header;
+
+  if (read_at(fd, &header, sizeof(header), 0) && valid(header)) {
+    records.resize(std::min<uint64_t>(header.total, capacity));
+
+    if (!read_at(fd, records.data(), records.size() * sizeof(Record),
+                 sizeof(Header)))
+      records.clear();
+    else if (records.size() == capacity) // Slots from next on are older
+      std::ranges::rotate(records, records.begin() + header.next);
+  }
+
+  close(fd);
+  return records;
+}
+} // namespace history
@@ -0,0 +1,107 @@
+/**
+ * @file io_executor.cpp
+ * @brief Gives functionality to io_executor.h
+ * @version 0.1
+ * @date 2025-04-06
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#include "../include/io_executor.h"
+
+#include <algorithm>
+
+/**
+ * @brief Construct a new IO_Executor object
+ *
+ * @param _max_workers Maximum number of worker threads
+ */
+IO_Executor::IO_Executor(size_t _max_workers)
+    : max_workers(std::max<size_t>(_max_workers, 1)) {}
+
+/**
+ * @brief Destroy the IO_Executor object (waits for workers to finish)
+ *
+ */
+IO_Executor::~IO_Executor() {
+  {
+    const std::lock_guard lock(mutex);
+    stopping = true;
+  }
+
+  jobs_ready.notify_all();
+
+  for (auto &worker : workers)
+    worker.join();
+}
+
+/**
+ * @brief Queues job for a worker, starting another worker if every running
+ * one is busy
+ *
+ * @param job Job
+ */
+void IO_Executor::post(std::function<void()> job) {
+  {
+    const std::lock_guard lock(mutex);
+    jobs.push_back(std::move(job));
+
+    if (jobs.size() > idle_workers && workers.size() < max_workers)
+      workers.emplace_back(&IO_Executor::work, this);
+  }
+
+  jobs_ready.notify_one();
+}
+
+/**
+ * @brief Queues coroutine to be resumed on the driving thread
+ *
+ * @param handle Coroutine
+ */
+void IO_Executor::resume_later(std::coroutine_handle<> handle) {
+  {
+    const std::lock_guard lock(mutex);
+    resumes.push_back(handle);
+  }
+
+  resumes_ready.notify_one();
+}
+
+/**
+ * @brief Waits for the next finished operation and resumes its coroutine
+ *
+ */
+void IO_Executor::resume_next() {
+  std::unique_lock lock(mutex);
+  resumes_ready.wait(lock, [this] { return !resumes.empty(); });
+
+  const std::coroutine_handle<> handle = resumes.front();
+  resumes.pop_front();
+  lock.unlock();
+
+  handle.resume();
+}
+
+/**
+ * @brief Worker loop
+ *
+ */
+void IO_Executor::work() {
+  std::unique_lock lock(mutex);
+
+  while (true) {
+    idle_workers++;
+    jobs_ready.wait(lock, [this] { return stopping || !jobs.empty(); });
+    idle_workers--;
+
+    if (jobs.empty())
+      return; // Stopping
+
+    std::function<void()> job = std::move(jobs.front());
+    jobs.pop_front();
+
+    lock.unlock();
+    job();
+    lock.lock();
+  }
+}
\ No newline at end of file
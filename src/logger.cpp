@@ -8,12 +8,24 @@
  *
  */
 #include "../include/logger.h"
+#include "../include/progress.h"
 
+#include <atomic>
 #include <cstdint>
-#include <cstdlib>
-#include <fstream>
 #include <iostream>
 
+namespace {
+/* Sink of the calling thread (nullptr for the console) */
+thread_local Log_Sink *current_sink = nullptr;
+
+/* Status line of the calling thread shown below logged lines, success and
+ * custom lines are suppressed while it is set */
+thread_local Progress *current_progress = nullptr;
+
+/* Lines logged to the console (runs on different threads share it) */
+std::atomic<uint64_t> logger_count = 0;
+} // namespace
+
 /**
  * @brief Get method for logger class
  *
@@ -56,6 +68,36 @@ void Logger::disable_coloring() {
   }
 }
 
+/**
+ * @brief Sends lines logged by the calling thread to sink, prompts are then
+ * answered with an empty line (no for y/n prompts) and no status line is
+ * shown
+ *
+ * @param sink Sink (nullptr for the console), must outlive its use
+ */
+void Logger::set_sink(Log_Sink *sink) { current_sink = sink; }
+
+/**
+ * @brief Gets sink of the calling thread
+ *
+ * @return Log_Sink* (nullptr for the console)
+ */
+Log_Sink *Logger::sink() const { return current_sink; }
+
+/**
+ * @brief Sets status line of the calling thread
+ *
+ * @param progress Status line (nullptr for none)
+ */
+void Logger::set_progress(Progress *progress) { current_progress = progress; }
+
+/**
+ * @brief Gets status line of the calling thread
+ *
+ * @return Progress* (nullptr if none is shown)
+ */
+Progress *Logger::progress() const { return current_progress; }
+
 /**
  * @brief Flushes output buffer
  *
@@ -63,28 +105,40 @@ void Logger::disable_coloring() {
 void Logger::flush_buffer() const { std::cout.flush(); }
 
 /**
- * @brief Handles logger count
+ * @brief Handles logger count (erases status line first, so the logged line
+ * takes its place)
  *
  */
 void Logger::handle_logger_count() {
-  static uint64_t logger_count = 0;
+  if (current_progress != nullptr)
+    current_progress->clear();
+
+  const uint64_t count = logger_count++;
 
-  std::cout << colors["count"] << "[" << logger_count++ << "]"
-            << colors["reset"];
+  std::cout << colors["count"] << "[" << count << "]" << colors["reset"];
 
-  if (logger_count < 10)
+  if (count + 1 < 10)
     std::cout << " ";
 
-  if (logger_count < 100)
+  if (count + 1 < 100)
     std::cout << " ";
 }
 
 /**
- * @brief Logs success message to console
+ * @brief Logs success message to console (suppressed while a status line
+ * is shown)
  *
  * @param message Text to be logged
  */
 void Logger::success(const std::string &message) {
+  if (current_sink != nullptr) {
+    current_sink->line("success", message);
+    return;
+  }
+
+  if (current_progress != nullptr)
+    return;
+
   handle_logger_count();
   std::cout << colors["success"] << "[success]: " << colors["reset"] << message
             << "\n";
@@ -106,6 +160,11 @@ void Logger::success_q(const std::string &message, const std::string &quote) {
  * @param message Text to be logged
  */
 void Logger::error(const std::string &message) {
+  if (current_sink != nullptr) {
+    current_sink->line("error", message);
+    return;
+  }
+
   handle_logger_count();
   std::cerr << colors["error"] << "[error]: " << colors["reset"] << message
             << "\n";
@@ -127,6 +186,11 @@ void Logger::error_q(const std::string &message, const std::string &quote) {
  * @param message Text to be logged
  */
 void Logger::warn(const std::string &message) {
+  if (current_sink != nullptr) {
+    current_sink->line("warning", message);
+    return;
+  }
+
   handle_logger_count();
   std::cout << colors["warn"] << "[warning]: " << colors["reset"] << message
             << "\n";
@@ -143,7 +207,8 @@ void Logger::warn_q(const std::string &message, const std::string &quote) {
 }
 
 /**
- * @brief Logs custom message to console
+ * @brief Logs custom message to console (suppressed while a status line is
+ * shown)
  *
  * @param message Text to be logged
  * @param mtype Message type
@@ -151,12 +216,38 @@ void Logger::warn_q(const std::string &message, const std::string &quote) {
  */
 void Logger::custom(const std::string &message, const std::string &mtype,
                     const std::string &color) {
+  if (current_sink != nullptr) {
+    current_sink->line(mtype, message);
+    return;
+  }
+
+  if (current_progress != nullptr)
+    return;
+
   handle_logger_count();
   std::cout << ((raw_colors.find(color) != raw_colors.end()) ? raw_colors[color]
                                                              : colors[color])
             << "[" << mtype << "]: " << colors["reset"] << message << "\n";
 }
 
+/**
+ * @brief Prints line as it is (no count or type), for results other programs
+ * read, like the path:line matches of cpm find
+ *
+ * @param message Line
+ */
+void Logger::output(const std::string &message) {
+  if (current_sink != nullptr) {
+    current_sink->line("output", message);
+    return;
+  }
+
+  if (current_progress != nullptr)
+    current_progress->clear();
+
+  std::cout << message << "\n";
+}
+
 /**
  * @brief Logs an input prompt to console
  *
@@ -164,6 +255,11 @@ void Logger::custom(const std::string &message, const std::string &mtype,
  * @return std::string
  */
 std::string Logger::prompt(const std::string &message) {
+  if (current_sink != nullptr) {
+    current_sink->line("prompt", message);
+    return "";
+  }
+
   handle_logger_count();
 
   std::cout << colors["prompt"] << "[prompt]: " << colors["reset"] << message
@@ -183,6 +279,11 @@ std::string Logger::prompt(const std::string &message) {
  * @return false
  */
 bool Logger::prompt_yn(const std::string &message) {
+  if (current_sink != nullptr) {
+    current_sink->line("prompt", message + " [y/n]");
+    return false;
+  }
+
   std::string response;
   while (true) {
     response = prompt(message + " [y/n]");
@@ -197,46 +298,44 @@ bool Logger::prompt_yn(const std::string &message) {
 }
 
 /**
- * @brief Executes terminal command
+ * @brief Executes program and captures its output
  *
- * @param command Command to execute
- * @param must_populate_file Whether to throw error if command does not output
- * (optional)
- * @return true
- * @return false
+ * @param argv Program followed by its arguments
+ * @param timeout Time after which program is killed (optional)
+ * @return process::Result
  */
-bool Logger::execute(const std::string &command,
-                     const bool &must_populate_file) {
-  handle_logger_count();
+process::Result Logger::execute(const std::vector<std::string> &argv,
+                                const std::chrono::milliseconds &timeout) {
+  std::string command;
+
+  for (const auto &arg : argv)
+    command += (command.empty() ? "" : " ") + arg;
 
   /* Prefix */
-  std::cout << colors["execute"] << "[executing]: " << colors["reset"]
-            << command << "\n";
+  if (current_sink != nullptr)
+    current_sink->line("executing", command);
+  else {
+    handle_logger_count();
+    std::cout << colors["execute"] << "[executing]: " << colors["reset"]
+              << command << "\n";
+  }
 
   /* Execution */
-  std::system(command.c_str());
+  const process::Result result = process::run(argv, timeout);
 
-  /* Empty response is indicator of command execution failure */
-  if (must_populate_file) {
-    std::ifstream file("cpm.tmp");
-
-    if (!file.is_open()) {
-      error("could not open cpm.tmp");
-      return false;
-    }
-
-    // Checks if cpm.tmp file is empty
-    if (file.peek() == std::ifstream::traits_type::eof()) {
-      error_q("did not execute successfully", command);
-      file.close();
-
-      return false;
-    }
+  if (result.timed_out) {
+    error_q("timed out", command);
+    return result;
+  }
 
-    file.close();
+  if (result.exit_code != 0) {
+    error_q("did not execute successfully (exit code " +
+                std::to_string(result.exit_code) + ")",
+            command);
+    return result;
   }
 
   success_q("executed successfully", command);
 
-  return true;
+  return result;
 }
\ No newline at end of file
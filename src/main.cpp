@@ -7,22 +7,20 @@
  * @copyright Copyright (c) 2023
  *
  */
+#include "../include/cpm.h"
 #include "../include/data.h"
-#include "../include/directory.h"
+#include "../include/history.h"
 #include "../include/logger.h"
-#include "../include/misc.h"
 
-#include "../include/commands/class_command.h"
 #include "../include/commands/command_manager.h"
-#include "../include/commands/config_command.h"
-#include "../include/commands/fpair_command.h"
-#include "../include/commands/init_command.h"
-#include "../include/commands/struct_command.h"
 #include "../include/commands/version_command.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 /**
@@ -40,29 +38,29 @@ int main(int argc, char *argv[]) {
   Logger &logger = Logger::get();
   Data_Manager &data_manager = Data_Manager::get();
 
-  data_manager.read();
-
-  /* Overwrites colormap with config variables */
-  if (data_manager.config_has_key("text_coloring") &&
-      data_manager.config["text_coloring"] == "off") {
+  /* Parsing */
+  const std::string cmd = (argc > 1) ? argv[1] : "";
+  const Command_Entry *entry = Command_Manager::find(cmd);
+
+  /* Overwrites colormap with config variables (config is only loaded if the
+   * command depends on it, --help and errors before a command is found
+   * always load the coloring keys) */
+  const auto depends_on = [&](std::string_view key) {
+    return !entry || entry->depends_on(key);
+  };
+
+  if (depends_on("text_coloring") &&
+      data_manager.get_value("text_coloring") == "off") {
     logger.disable_coloring();
   } else {
     for (const auto &[k, v] : logger.colors) {
-      if (data_manager.config_has_key("color_" + k))
-        logger.set_color(k,
-                         logger.raw_colors[data_manager.config["color_" + k]]);
+      if (depends_on("color_" + k) &&
+          data_manager.config_has_key("color_" + k))
+        logger.set_color(
+            k, logger.raw_colors[data_manager.get_value("color_" + k)]);
     }
   }
 
-  /* Register commands */
-  Command_Manager manager;
-  manager.register_command("class", std::make_unique<Class_Command>());
-  manager.register_command("config", std::make_unique<Config_Command>());
-  manager.register_command("fpair", std::make_unique<Fpair_Command>());
-  manager.register_command("init", std::make_unique<Init_Command>());
-  manager.register_command("struct", std::make_unique<Struct_Command>());
-  manager.register_command("version", std::make_unique<Version_Command>());
-
   /* Checks if command was inputted */
   if (argc <= 1) {
     logger.error("no command provided");
@@ -71,54 +69,41 @@ int main(int argc, char *argv[]) {
     return 1;
   }
 
-  /* Parsing */
-  const std::string cmd = argv[1];
-  if (!manager.exists(cmd) & cmd != "--help") {
+  if (!entry & cmd != "--help") {
     logger.error_q("command does not exist, try using cpm --help", cmd);
     return 1;
   }
 
   std::vector<std::string> args;
-  std::vector<std::string> flags;
-
-  /* Flags */
-  for (int i = 0; i < argc; i++) {
-    std::string arg = argv[i];
-    if (arg[0] == '-' & arg.size() > 1) {
-      uint8_t _start = 1; // -f
-      if (arg[1] == '-' & arg.size() > 2)
-        _start = 2; // --flag
+  bool help_menu = cmd == "--help";
+  cpm::Options options;
 
-      flags.push_back(arg.substr(_start, arg.size()));
-    }
-  }
-
-  /* Arguments */
+  /* Determines if help menu needs to be displayed / plan only printed / files
+   * only kept in memory (--in-memory=[directory] dumps them afterwards) */
   for (int i = 2; i < argc; i++) {
-    std::string arg = argv[i];
-    if (arg[0] != '-')
-      args.push_back(arg);
+    const std::string_view arg = argv[i];
+
+    if (arg == "--help")
+      help_menu = true;
+    else if (arg == "--dry-run")
+      options.dry_run = true;
+    else if (arg == "--in-memory" || arg.starts_with("--in-memory=")) {
+      options.in_memory = true;
+      options.dump_folder =
+          arg.substr(std::min(arg.size(), sizeof("--in-memory")));
+    } else
+      args.emplace_back(arg);
   }
 
-  logger.success("parsed command");
-
-  /* Determines if help menu needs to be displayed */
-  const bool help_menu = misc::vector_contains(flags, "help");
-
-  /* Checks if minimum arguments requirement is met */
-  if (!help_menu) {
-    const uint16_t cmd_min_args = manager.get_min_args(cmd);
-    if (args.size() < cmd_min_args) {
-      logger.error_q("requires at least " + std::to_string(cmd_min_args) +
-                         " arguments",
-                     cmd);
-      return 1;
-    }
-  }
-
-  /* Command execution */
+  /* Command execution (flags are only parsed when the command runs) */
   uint8_t result;
   if (help_menu) {
+    std::erase_if(args, [](std::string_view arg) {
+      return arg.size() > 1 && arg[0] == '-';
+    });
+
+    logger.success("parsed command");
+
     if (cmd != "--help") {
       if (args.empty())
         args.push_back(cmd);
@@ -126,22 +111,34 @@ int main(int argc, char *argv[]) {
         args[0] = cmd;
     }
 
-    result = manager.help_menu(args);
+    result = Command_Manager().help_menu(args);
   }
 
   else
-    result = manager.execute(cmd, args, flags);
-
-  /* Saving data */
-  if ((result == 0) & (cmd != "--help") & (cmd != "version"))
-    data_manager.write();
-
-  /* Artifact cleanup */
-  directory::destroy_file("cpm.tmp");
+    result = cpm::run(cmd, args, options);
 
   /* Success message + time measurement */
   const auto end = std::chrono::high_resolution_clock::now();
 
+  /* Timing history (read by cpm stats), a failed write doesn't fail the
+   * command. Runs that are meant to leave the disk alone (help, version, dry
+   * and in-memory runs) aren't recorded, so stats doesn't count them */
+  if (!help_menu && cmd != Version_Command::name && !options.dry_run &&
+      !options.in_memory) {
+    history::Record record;
+    record.time = std::chrono::duration_cast<std::chrono::milliseconds>(
+                      std::chrono::system_clock::now().time_since_epoch())
+                      .count();
+    record.wall_time =
+        std::chrono::duration_cast<std::chrono::microseconds>(end - start)
+            .count();
+    record.arg_count = static_cast<uint16_t>(args.size());
+    record.exit_code = result;
+    record.set_command(cmd);
+    history::count_io(record);
+    history::append(record);
+  }
+
   logger.custom(
       "command \'" + cmd + "\' with exit code " + std::to_string(result) +
           " in " +
@@ -9,6 +9,7 @@
  */
 #include "../include/misc.h"
 #include "../include/logger.h"
+#include "../include/paths.h"
 
 #include <algorithm>
 #include <cstdlib>
@@ -63,15 +64,34 @@ std::vector<std::string> split_string(const std::string &s,
 }
 
 /**
- * @brief Gets the value of flags in the format of flag=value
+ * @brief Splits a string into views based on a specified delimeter (views
+ * point into s, the vector itself is allocated from memory)
  *
- * @param flag Raw flag
- * @return std::string
+ * @param s String to split
+ * @param delimiter String to split by
+ * @param memory Memory resource (usually a command's arena)
+ * @return std::pmr::vector<std::string_view>
  */
-std::string get_flag_value(const std::string &flag) {
-  return (flag.find("=") != std::string::npos)
-             ? flag.substr(flag.find("=") + 1, flag.length())
-             : "";
+std::pmr::vector<std::string_view>
+split_string(std::string_view s, std::string_view delimiter,
+             std::pmr::memory_resource *memory) {
+  std::pmr::vector<std::string_view> tokens(memory);
+  size_t start = 0, end = 0;
+
+  if (delimiter.empty()) // Provided delimiter is ""
+  {
+    tokens.emplace_back(s);
+    return tokens;
+  }
+
+  while ((end = s.find(delimiter, start)) != std::string_view::npos) {
+    tokens.emplace_back(s.substr(start, end - start));
+    start = end + delimiter.length();
+  }
+
+  tokens.emplace_back(s.substr(start));
+
+  return tokens;
 }
 
 /**
@@ -133,12 +153,14 @@ std::string join_string_vector(const std::vector<std::string> &vect,
  * @param str String
  */
 void auto_capitalize(std::string &str) {
-  std::vector<std::string> split_str = split_string(str, "_");
+  bool capitalize = true;
 
-  for (auto &token : split_str)
-    token[0] = std::toupper(token[0]);
+  for (auto &ch : str) {
+    if (capitalize)
+      ch = std::toupper(ch);
 
-  str = misc::join_string_vector(split_str, "_");
+    capitalize = ch == '_';
+  }
 }
 
 /**
@@ -149,27 +171,18 @@ void auto_capitalize(std::string &str) {
  */
 char compare_paths(const std::filesystem::path &p1,
                    const std::filesystem::path &p2) {
-  const std::vector<std::string> t_split(split_string(p1.string(), "/")),
-      o_split(split_string(p2.string(),
-                           "/")); // t_split = this_split, o_split = other_split
-  size_t location = 0;
-
-  for (; location <
-         ((t_split.size() > o_split.size()) ? o_split.size() : t_split.size());
-       location++) { // Iterate until smallest path size
-    if (t_split[location] == o_split[location])
-      continue;
+  const std::string_view s1(p1.native()), s2(p2.native());
+  const size_t common = paths::common_segments(s1, s2);
+  const size_t p1_rest = paths::segment_count(paths::skip_segments(s1, common)),
+               p2_rest = paths::segment_count(paths::skip_segments(s2, common));
 
-    if (sub_vector(t_split, location, t_split.size() - 1).size() >
-            sub_vector(o_split, location, o_split.size() - 1).size() |
-        sub_vector(t_split, location, t_split.size() - 1).size() ==
-            sub_vector(o_split, location, o_split.size() - 1).size())
-      return -1; // p1 file is "further in" or "equally in" than p2 file
-    else
-      return 1; // p2 file is "further in" than p1 file
-  }
+  if (p1_rest == 0 || p2_rest == 0)
+    return 0; // fallback (one path contains the other)
+
+  if (p1_rest >= p2_rest)
+    return -1; // p1 file is "further in" or "equally in" than p2 file
 
-  return 0; // fallback
+  return 1; // p2 file is "further in" than p1 file
 }
 
 /**
@@ -181,19 +194,10 @@ char compare_paths(const std::filesystem::path &p1,
  */
 std::filesystem::path trim_path(const std::filesystem::path &p1,
                                 const std::filesystem::path &p2) {
-  const std::vector<std::string> t_split(split_string(p1.string(), "/")),
-      o_split(split_string(p2.string(),
-                           "/")); // t_split = this_split, o_split = other_split
-  size_t location = 0;
-
-  for (; location <
-         ((t_split.size() > o_split.size()) ? o_split.size() : t_split.size());
-       location++) // Iterate until smallest path size
-    if (t_split[location] != o_split[location])
-      break;
-
-  return std::filesystem::path(misc::join_string_vector(
-      misc::sub_vector(t_split, location, t_split.size() - 1), "/"));
+  const std::string_view s1(p1.native());
+
+  return std::filesystem::path(
+      paths::skip_segments(s1, paths::common_segments(s1, p2.native())));
 }
 
 /**
@@ -205,38 +209,8 @@ std::filesystem::path trim_path(const std::filesystem::path &p1,
  */
 void set_relative_path(std::string &p, const std::filesystem::path &p1,
                        const std::filesystem::path &p2) {
-  /* Get relative path difference */
-  const char path_diff(compare_paths(p1, p2));
-
-  if (path_diff < 0) {
-    /* Figure out last common path */
-    const std::vector<std::string> split_header_p_path(
-        split_string(std::filesystem::absolute(p2).string(), "/")),
-        split_header_path(
-            split_string(std::filesystem::absolute(p1).string(), "/"));
-    size_t location = 0;
-
-    for (; location < split_header_p_path.size(); location++)
-      if (split_header_p_path[location] != split_header_path[location])
-        break;
-
-    /* Add ../ to path to get to last common path */
-    for (size_t i = 0; i < (split_header_path.size() - location - 1); i++)
-      p += "../";
-
-    /* Add trimmed paths together */
-    p += trim_path(p2, p1).parent_path().string();
-  } else if (path_diff > 0)
-    p += trim_path(p2, p1).parent_path().string() + "/";
-
-  if (p[p.size() - 1] != '/')
-    p += "/";
-
-  if (p.length() > 0 && p[0] == '/')
-    p = p.substr(1);
-  else if (p.length() > 1 && (p[0] == '.' & p[1] == '/'))
-    p = p.substr(2);
-  p += p2.filename().string();
+  paths::append_relative(p, paths::parent(paths::absolute(p1)),
+                         paths::absolute(p2));
 }
 
 /**
@@ -258,4 +232,81 @@ void replace_string_instances(std::string &s, const std::string &i1,
     pos += i2.length();
   }
 }
+
+/**
+ * @brief Checks if any space or newline separated word in text starts with
+ * token
+ *
+ * @param text Text to search
+ * @param token Token to find
+ * @return true
+ * @return false
+ */
+bool has_token(std::string_view text, std::string_view token) {
+  size_t start = 0;
+
+  for (size_t i = 0; i <= text.size(); i++) {
+    if (i < text.size() && text[i] != ' ' && text[i] != '\n')
+      continue;
+
+    if (text.substr(start, i - start).starts_with(token))
+      return true;
+
+    start = i + 1;
+  }
+
+  return false;
+}
+
+/**
+ * @brief Matches '/' separated path against glob pattern, '*' matches within
+ * one segment, '?' matches one character (except '/'), '**' matches across
+ * segments (followed by '/' it also matches no segment at all)
+ *
+ * @param pattern Glob pattern
+ * @param text Path
+ * @return true
+ * @return false
+ */
+bool glob_match(std::string_view pattern, std::string_view text) {
+  while (!pattern.empty()) {
+    if (pattern.starts_with("**")) {
+      pattern.remove_prefix(2);
+      const bool whole_segments = pattern.starts_with('/');
+
+      if (whole_segments)
+        pattern.remove_prefix(1);
+
+      for (size_t i = 0; i <= text.size(); i++)
+        if ((!whole_segments || i == 0 || text[i - 1] == '/') &&
+            glob_match(pattern, text.substr(i)))
+          return true;
+
+      return false;
+    }
+
+    if (pattern.front() == '*') {
+      pattern.remove_prefix(1);
+
+      for (size_t i = 0; i <= text.size(); i++) {
+        if (glob_match(pattern, text.substr(i)))
+          return true;
+
+        if (i < text.size() && text[i] == '/')
+          break;
+      }
+
+      return false;
+    }
+
+    if (text.empty() || (pattern.front() == '?' && text.front() == '/') ||
+        (pattern.front() != '?' && pattern.front() != text.front()))
+      return false;
+
+    pattern.remove_prefix(1);
+    text.remove_prefix(1);
+  }
+
+  return text.empty();
+}
 } // namespace misc
@@ -0,0 +1,259 @@
+/**
+ * @file paths.cpp
+ * @brief Path algebra on string_views (no intermediate segment vectors)
+ * @version 0.1
+ * @date 2025-03-16
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#include "../include/paths.h"
+
+#include <functional>
+#include <unordered_map>
+
+namespace {
+/* Project root of the calling thread (nullptr for the working directory) */
+thread_local const std::string *project_root = nullptr;
+
+/**
+ * @brief Hashes strings and string views alike, so paths are looked up
+ * without building a key string
+ *
+ */
+struct View_Hash {
+  using is_transparent = void;
+
+  size_t operator()(std::string_view text) const {
+    return std::hash<std::string_view>{}(text);
+  }
+};
+
+/* Normalized absolute paths of the calling thread by the path they were
+ * asked for, kept until forget is called */
+thread_local std::unordered_map<std::string, std::string, View_Hash,
+                                std::equal_to<>>
+    interned;
+
+/* Key of the last relative path looked up (reused, so its buffer is only
+ * allocated once per thread) */
+thread_local std::string relative_key;
+} // namespace
+
+namespace paths {
+/**
+ * @brief Counts segments in path
+ *
+ * @param path Path
+ * @return size_t
+ */
+size_t segment_count(std::string_view path) {
+  size_t count = 0;
+
+  for (Segment_Iterator it(path), end; it != end; ++it)
+    count++;
+
+  return count;
+}
+
+/**
+ * @brief Counts leading segments shared by two paths
+ *
+ * @param p1
+ * @param p2
+ * @return size_t
+ */
+size_t common_segments(std::string_view p1, std::string_view p2) {
+  size_t count = 0;
+  Segment_Iterator it1(p1), it2(p2), end;
+
+  for (; it1 != end && it2 != end && *it1 == *it2; ++it1, ++it2)
+    count++;
+
+  return count;
+}
+
+/**
+ * @brief Gets the part of path after its first count segments
+ *
+ * @param path Path
+ * @param count Number of segments to skip
+ * @return std::string_view (view into path)
+ */
+std::string_view skip_segments(std::string_view path, size_t count) {
+  Segment_Iterator it(path), end;
+
+  for (; count > 0 && it != end; count--)
+    ++it;
+
+  if (it == end)
+    return {};
+
+  return path.substr(it->data() - path.data());
+}
+
+/**
+ * @brief Gets parent directory of path
+ *
+ * @param path Path
+ * @return std::string_view (view into path)
+ */
+std::string_view parent(std::string_view path) {
+  while (path.size() > 1 && path.back() == '/')
+    path.remove_suffix(1);
+
+  const size_t pos = path.find_last_of('/');
+
+  if (pos == std::string_view::npos)
+    return {};
+
+  return path.substr(0, (pos == 0) ? 1 : pos);
+}
+
+/**
+ * @brief Gets normalized absolute form of path (relative paths are resolved
+ * against the project root of the calling thread), each distinct path is
+ * only resolved once until forget is called (once per run)
+ *
+ * @param path Path
+ * @return const std::string& (stays valid until forget is called)
+ */
+const std::string &absolute(const std::filesystem::path &path) {
+  /* Relative paths are keyed by the root they resolve against (the working
+   * directory only changes between runs) */
+  std::string_view key = path.native();
+
+  if (project_root != nullptr && !path.is_absolute()) {
+    relative_key = *project_root;
+
+    if (!path.empty()) {
+      relative_key += '/';
+      relative_key += path.native();
+    }
+
+    key = relative_key;
+  }
+
+  auto it = interned.find(key);
+
+  if (it == interned.end())
+    it = interned
+             .emplace(key, std::filesystem::absolute(key)
+                               .lexically_normal()
+                               .generic_string())
+             .first;
+
+  return it->second;
+}
+
+/**
+ * @brief Drops the paths absolute resolved on the calling thread, the
+ * project root stays set
+ *
+ */
+void forget() {
+  const std::string root_path = project_root ? *project_root : "";
+
+  interned.clear();
+
+  if (!root_path.empty())
+    project_root = &absolute(root_path);
+}
+
+/**
+ * @brief Gets path relative to the project root of the calling thread
+ *
+ * @param path Path
+ * @return std::optional<std::string_view> ("" for the root itself, empty if
+ * path is outside project root, stays valid for the rest of the run)
+ */
+std::optional<std::string_view>
+root_relative(const std::filesystem::path &path) {
+  const std::string &project = root();
+  std::string_view target = paths::absolute(path);
+
+  while (target.size() > 1 && target.ends_with('/'))
+    target.remove_suffix(1);
+
+  if (!target.starts_with(project))
+    return std::nullopt;
+
+  target.remove_prefix(project.size());
+
+  if (!target.empty() && target.front() != '/' && !project.ends_with('/'))
+    return std::nullopt; // Sibling sharing a name prefix
+
+  while (target.starts_with('/'))
+    target.remove_prefix(1);
+
+  return target;
+}
+
+/**
+ * @brief Sets project root of the calling thread, relative paths of every
+ * directory:: function, File and Plan resolve against it
+ *
+ * @param path Project root (the working directory if empty)
+ */
+void set_root(const std::filesystem::path &path) {
+  if (path.empty()) {
+    project_root = nullptr;
+    return;
+  }
+
+  std::filesystem::path normal =
+      std::filesystem::absolute(path).lexically_normal();
+
+  if (!normal.has_filename() && normal.has_parent_path())
+    normal = normal.parent_path(); // Trailing '/'
+
+  project_root = &paths::absolute(normal);
+}
+
+/**
+ * @brief Checks if a project root is set on the calling thread (root falls
+ * back to the working directory otherwise)
+ *
+ * @return true
+ * @return false
+ */
+bool has_root() { return project_root != nullptr; }
+
+/**
+ * @brief Gets project root of the calling thread
+ *
+ * @return const std::string& (absolute and normalized)
+ */
+const std::string &root() {
+  if (project_root != nullptr)
+    return *project_root;
+
+  return paths::absolute(std::filesystem::current_path());
+}
+
+/**
+ * @brief Appends relative path from directory from_dir to to (both absolute
+ * and normalized), matches std::filesystem::path::lexically_relative
+ *
+ * @param out String to append to
+ * @param from_dir Directory to start from
+ * @param to Target path
+ */
+void append_relative(std::string &out, std::string_view from_dir,
+                     std::string_view to) {
+  const size_t start = out.size();
+  const size_t common = common_segments(from_dir, to);
+
+  for (size_t ups = segment_count(from_dir) - common; ups > 0; ups--)
+    out += "../";
+
+  const std::string_view rest = skip_segments(to, common);
+
+  if (rest.empty() && out.size() > start)
+    out.pop_back(); // Trailing '/' of last '../'
+  else if (rest.empty())
+    out += '.';
+  else
+    out += rest;
+}
+} // namespace paths
\ No newline at end of file
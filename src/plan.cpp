@@ -0,0 +1,736 @@
+/**
+ * @file plan.cpp
+ * @brief Gives functionality to plan.h
+ * @version 0.1
+ * @date 2025-04-13
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#include "../include/plan.h"
+#include "../include/directory.h"
+#include "../include/file_index.h"
+#include "../include/logger.h"
+#include "../include/paths.h"
+#include "../include/progress.h"
+#include "../include/vfs.h"
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <fcntl.h>
+#include <vector>
+
+namespace {
+constexpr std::array<std::string_view, 6> op_names = {
+    "mkdir", "create", "write", "append", "patch", "remove",
+};
+
+/* Files written through the ring between progress updates */
+constexpr size_t progress_slice = 1024;
+
+Logger &logger = Logger::get();
+
+/**
+ * @brief Reads whole file (empty if it doesn't exist)
+ *
+ * @param path Path to file
+ * @return std::string
+ */
+std::string read_file(std::string_view path) {
+  std::string text;
+
+  if (!Vfs::current().read(path, text))
+    text.clear();
+
+  return text;
+}
+
+/**
+ * @brief Logs failed file operation
+ *
+ * @param op Operation
+ * @param path Path to file
+ */
+void log_failure(Op_Type op, std::string_view path) {
+  logger.error_q("failed to " +
+                     std::string(op_names[static_cast<size_t>(op)]),
+                 std::string(path));
+}
+} // namespace
+
+/**
+ * @brief Construct a new Plan object
+ *
+ * @param _memory Memory resource for recorded operations
+ */
+Plan::Plan(std::pmr::memory_resource *_memory)
+    : memory(_memory), files(_memory), folders(_memory) {}
+
+/**
+ * @brief Gets merged state of file at path
+ *
+ * @param path Path to file
+ * @return File_Plan&
+ */
+Plan::File_Plan &Plan::at(const std::filesystem::path &path) {
+  return files.try_emplace(paths::absolute(path), memory).first->second;
+}
+
+/**
+ * @brief Gets emitter that appends to file, consecutive appends share one
+ *
+ * @param file File state
+ * @return Emitter&
+ */
+Emitter &Plan::append_edit(File_Plan &file) {
+  if (file.edits.empty() || file.edits.back().type != Op_Type::append)
+    file.edits.push_back({Op_Type::append, Emitter(memory), {}, {}});
+
+  return file.edits.back().content;
+}
+
+/**
+ * @brief Gets deepest directories that have to exist (explicit directories
+ * plus parents of files), creating those creates every other one
+ *
+ * @return std::pmr::vector<std::string_view>
+ */
+std::pmr::vector<std::string_view> Plan::leaf_folders() const {
+  std::pmr::set<std::string_view> all(folders, memory);
+
+  for (const auto &[path, file] : files)
+    if (!file.removed)
+      all.insert(paths::parent(path));
+
+  std::pmr::vector<std::string_view> leaves(memory);
+
+  for (const auto &folder : all) {
+    /* Descendants sort directly after folder + '/' */
+    std::pmr::string prefix(folder, memory);
+
+    if (!prefix.ends_with('/'))
+      prefix += '/';
+
+    const auto next = all.lower_bound(prefix);
+
+    if (next == all.end() || !next->starts_with(prefix))
+      leaves.push_back(folder);
+  }
+
+  return leaves;
+}
+
+/**
+ * @brief Gets operation that describes merged state of file
+ *
+ * @param file File state
+ * @return Op_Type
+ */
+Op_Type Plan::final_op(const File_Plan &file) {
+  if (file.removed)
+    return Op_Type::remove;
+
+  if (std::ranges::any_of(file.edits, [](const Edit &edit) {
+        return edit.type == Op_Type::patch;
+      }))
+    return Op_Type::patch;
+
+  if (file.edits.empty())
+    return Op_Type::create;
+
+  return file.truncated ? Op_Type::write : Op_Type::append;
+}
+
+/**
+ * @brief Renders contents file will have once plan is executed
+ *
+ * @param path Path to file
+ * @param file File state
+ * @return std::string
+ */
+std::string Plan::render(std::string_view path, const File_Plan &file) {
+  if (file.removed)
+    return "";
+
+  std::string text = file.truncated ? "" : read_file(path);
+
+  for (const auto &edit : file.edits) {
+    if (edit.type == Op_Type::append) {
+      edit.content.render(text);
+      continue;
+    }
+
+    const size_t pos = text.find(edit.find);
+
+    if (pos != std::string::npos)
+      text.replace(pos, edit.find.size(), edit.replace);
+
+    /* Patched files are rewritten line by line */
+    if (!text.empty() && !text.ends_with('\n'))
+      text += '\n';
+  }
+
+  return text;
+}
+
+/**
+ * @brief Checks if file already is in its planned state (write, append and
+ * create only), so writing it would only bump its mtime
+ *
+ * @param path Path to file
+ * @param file File state
+ * @return true
+ * @return false
+ */
+bool Plan::unchanged(std::string_view path, const File_Plan &file) {
+  Vfs &vfs = Vfs::current();
+
+  switch (final_op(file)) {
+  case Op_Type::write: {
+    const Emitter &content = file.edits.front().content;
+    return vfs.same_contents(path, content.get_fragments(), content.size());
+  }
+
+  case Op_Type::append:
+    if (file.edits.front().content.size() != 0)
+      return false;
+
+    [[fallthrough]];
+
+  case Op_Type::create:
+    return vfs.exists(path) &&
+           (!file.truncated || vfs.same_contents(path, {}, 0));
+
+  default:
+    return false;
+  }
+}
+
+/**
+ * @brief Brings file to its planned state through the current filesystem,
+ * files already in that state are left untouched (runs on an executor
+ * worker when the filesystem is on disk, so it must not log)
+ *
+ * @param path Path to file
+ * @param file File state
+ * @return Outcome
+ */
+Plan::Outcome Plan::apply(std::string_view path, const File_Plan &file) {
+  Vfs &vfs = Vfs::current();
+  const Op_Type op = final_op(file);
+  bool success;
+
+  if (unchanged(path, file))
+    return Outcome::unchanged;
+
+  switch (op) {
+  case Op_Type::remove:
+    success = vfs.remove(path);
+    break;
+
+  case Op_Type::patch: {
+    const std::string text = render(path, file);
+    const std::string_view contents = text;
+
+    if (vfs.same_contents(path, {&contents, 1}, text.size()))
+      return Outcome::unchanged;
+
+    Emitter emitter;
+    emitter.append(text);
+
+    success = vfs.replace(path, emitter);
+    break;
+  }
+
+  case Op_Type::write:
+  case Op_Type::append:
+    /* Without patches all appends were merged into one edit */
+    success = file.replaced
+                  ? vfs.replace(path, file.edits.front().content)
+                  : vfs.write(path, file.edits.front().content,
+                              !file.truncated);
+    break;
+
+  default:
+    success = vfs.write(path, Emitter(), !file.truncated);
+  }
+
+  return success ? Outcome::changed : Outcome::failed;
+}
+
+/**
+ * @brief Counts file in summary and progress by outcome of bringing it to
+ * its planned state, failures are logged
+ *
+ * @param outcome Outcome
+ * @param path Path to file
+ * @param file File state
+ * @param summary Summary to count file in
+ * @param progress Progress to count file in
+ * @return true
+ * @return false
+ */
+bool Plan::record(Outcome outcome, std::string_view path,
+                  const File_Plan &file, Summary &summary,
+                  Progress &progress) {
+  progress.advance(path);
+
+  switch (outcome) {
+  case Outcome::failed:
+    log_failure(final_op(file), path);
+    return false;
+
+  case Outcome::unchanged:
+    summary.unchanged++;
+    break;
+
+  case Outcome::changed:
+    (final_op(file) == Op_Type::remove ? summary.removed : summary.written)++;
+  }
+
+  return true;
+}
+
+/**
+ * @brief Checks if file can be brought to its planned state by one io_uring
+ * removal or linked open -> write -> close chain (its contents don't depend
+ * on the disk)
+ *
+ * @param file File state
+ * @return true
+ * @return false
+ */
+bool Plan::batchable(const File_Plan &file) {
+  const Op_Type op = final_op(file);
+
+  if (op == Op_Type::create || op == Op_Type::remove)
+    return true;
+
+  return (op == Op_Type::write || op == Op_Type::append) && !file.replaced &&
+         file.edits.front().content.get_fragments().size() <= IOV_MAX;
+}
+
+/**
+ * @brief Creates planned directories, with io_uring every missing directory
+ * of one depth is created in one submission (shallowest first)
+ *
+ * @param ring Ring (create_directories is used if it is unavailable)
+ * @return true
+ * @return false
+ */
+bool Plan::create_folders(Uring &ring) const {
+  bool success = true;
+
+  if (!ring.available()) {
+    for (const auto &folder : leaf_folders()) {
+      const std::filesystem::path path(folder);
+      directory::create_folders({path});
+
+      if (!directory::has_folder(path)) {
+        logger.error_q("could not be created", std::string(folder));
+        success = false;
+      }
+    }
+
+    return success;
+  }
+
+  std::pmr::set<std::string_view> seen(memory);
+  std::pmr::vector<std::string_view> missing(memory);
+
+  for (const auto &leaf : leaf_folders())
+    for (std::string_view folder = leaf;
+         !folder.empty() && seen.insert(folder).second &&
+         !directory::has_folder(folder);
+         folder = paths::parent(folder))
+      missing.push_back(folder);
+
+  std::ranges::stable_sort(missing, {}, paths::segment_count);
+
+  std::pmr::vector<Uring::Entry> level(memory);
+
+  for (size_t start = 0, end = 0; start < missing.size(); start = end) {
+    const size_t depth = paths::segment_count(missing[start]);
+    level.clear();
+
+    for (end = start;
+         end < missing.size() && paths::segment_count(missing[end]) == depth;
+         end++) {
+      const directory::At_Path target = directory::at(missing[end]);
+      level.push_back({target.dirfd, target.path});
+    }
+
+    if (ring.make_folders(level))
+      continue;
+
+    for (size_t i = 0; i < level.size(); i++)
+      if (level[i].error != 0) {
+        logger.error_q("could not be created",
+                       std::string(missing[start + i]));
+        success = false;
+      }
+  }
+
+  return success;
+}
+
+/**
+ * @brief Executes file operation on a worker of executor
+ *
+ * @param executor IO executor
+ * @param root Project root of the run (workers have none of their own)
+ * @param path Path to file
+ * @param file File state
+ * @param summary Summary to count file in
+ * @param progress Progress to count file in
+ * @return Task<bool>
+ */
+Task<bool> Plan::execute_file(IO_Executor &executor, const std::string &root,
+                              std::string_view path, const File_Plan &file,
+                              Summary &summary, Progress &progress) const {
+  const Outcome outcome = co_await executor.io([&] {
+    if (!paths::has_root() || paths::root() != root)
+      paths::set_root(root); // Paths resolve through the run's handles
+
+    return apply(path, file);
+  });
+
+  co_return record(outcome, path, file, summary, progress);
+}
+
+/**
+ * @brief Copies text into plan storage, so it can be viewed by recorded
+ * contents after the caller's copy is gone
+ *
+ * @param text Text
+ * @return std::string_view
+ */
+std::string_view Plan::keep(std::string_view text) {
+  if (text.empty())
+    return {};
+
+  char *const data = static_cast<char *>(memory->allocate(text.size(), 1));
+  std::ranges::copy(text, data);
+
+  return {data, text.size()};
+}
+
+/**
+ * @brief Records creation of directory (and its parents)
+ *
+ * @param path Path to directory
+ */
+void Plan::mkdir(const std::filesystem::path &path) {
+  folders.insert(paths::absolute(path));
+}
+
+/**
+ * @brief Records creation of file (existing contents are kept)
+ *
+ * @param path Path to file
+ */
+void Plan::create(const std::filesystem::path &path) {
+  File_Plan &file = at(path);
+
+  if (file.removed) {
+    file.removed = false;
+    file.truncated = true;
+  }
+
+  file.created = true;
+}
+
+/**
+ * @brief Records overwrite of file, contents are rendered into the returned
+ * emitter
+ *
+ * @param path Path to file
+ * @return Emitter&
+ */
+Emitter &Plan::write(const std::filesystem::path &path) {
+  File_Plan &file = at(path);
+  file.created = file.truncated = true;
+  file.replaced = file.removed = false;
+  file.edits.clear();
+
+  return append_edit(file);
+}
+
+/**
+ * @brief Records overwrite of file that is written to a temporary file and
+ * renamed over it, so readers never see it half-written
+ *
+ * @param path Path to file
+ * @return Emitter&
+ */
+Emitter &Plan::replace(const std::filesystem::path &path) {
+  Emitter &content = write(path);
+  at(path).replaced = true;
+
+  return content;
+}
+
+/**
+ * @brief Records append to file, contents are rendered into the returned
+ * emitter
+ *
+ * @param path Path to file
+ * @return Emitter&
+ */
+Emitter &Plan::append(const std::filesystem::path &path) {
+  File_Plan &file = at(path);
+
+  if (file.removed) {
+    file.removed = false;
+    file.truncated = true;
+  }
+
+  file.created = true;
+
+  return append_edit(file);
+}
+
+/**
+ * @brief Records replacement of first occurrence of find with replace
+ *
+ * @param path Path to file
+ * @param find Text to find
+ * @param replace Text to replace with
+ */
+void Plan::patch(const std::filesystem::path &path, std::string_view find,
+                 std::string_view replace) {
+  at(path).edits.push_back(
+      {Op_Type::patch, Emitter(memory), keep(find), keep(replace)});
+}
+
+/**
+ * @brief Records removal of file (nothing is recorded if it doesn't exist)
+ *
+ * @param path Path to file
+ * @param listed Path was just listed from its directory (it isn't checked
+ * again)
+ */
+void Plan::remove(const std::filesystem::path &path, const bool &listed) {
+  if (!listed && !exists(path))
+    return;
+
+  File_Plan &file = at(path);
+  file.removed = true;
+  file.created = file.truncated = file.replaced = false;
+  file.edits.clear();
+}
+
+/**
+ * @brief Sets line logged once the plan was executed without failures (a dry
+ * run doesn't log it)
+ *
+ * @param message Text to be logged
+ */
+void Plan::on_success(std::string_view message) {
+  success_message = keep(message);
+}
+
+/**
+ * @brief Checks if file will exist once plan is executed
+ *
+ * @param path Path to file
+ * @return true
+ * @return false
+ */
+bool Plan::exists(const std::filesystem::path &path) const {
+  const auto file = files.find(paths::absolute(path));
+
+  if (file == files.end())
+    return directory::has_file(path);
+
+  return !file->second.removed &&
+         (file->second.created || directory::has_file(path));
+}
+
+/**
+ * @brief Gets contents file will have once plan is executed
+ *
+ * @param path Path to file
+ * @return std::string
+ */
+std::string Plan::contents(const std::filesystem::path &path) const {
+  const std::string &key = paths::absolute(path);
+  const auto file = files.find(key);
+
+  if (file == files.end())
+    return read_file(key);
+
+  return render(key, file->second);
+}
+
+/**
+ * @brief Prints plan (paths relative to project root)
+ *
+ */
+void Plan::print() const {
+  const std::string &cwd = paths::root();
+  std::string shown;
+
+  for (const auto &folder : leaf_folders()) {
+    if (directory::has_folder(folder))
+      continue;
+
+    shown.clear();
+    paths::append_relative(shown, cwd, folder);
+    logger.custom(shown, "mkdir", "theme");
+  }
+
+  for (const auto &[path, file] : files) {
+    const Op_Type op = final_op(file);
+
+    /* Planned and then removed again, nothing happens to it */
+    if (op == Op_Type::remove && !directory::has_file(path))
+      continue;
+
+    shown.clear();
+    paths::append_relative(shown, cwd, path);
+
+    if (op == Op_Type::write || op == Op_Type::append)
+      shown += " (" + std::to_string(file.edits.front().content.size()) +
+               " bytes)";
+
+    for (const auto &edit : file.edits)
+      if (edit.type == Op_Type::patch)
+        shown += " ('" + std::string(edit.find) + "' -> '" +
+                 std::string(edit.replace) + "')";
+
+    logger.custom(shown, std::string(op_names[static_cast<size_t>(op)]),
+                  "theme");
+  }
+}
+
+/**
+ * @brief Executes plan, directories first and then every file concurrently
+ * (through io_uring chains where possible, otherwise on executor workers),
+ * files of a filesystem that isn't on disk are applied one by one
+ *
+ * @return true
+ * @return false
+ */
+bool Plan::execute() const {
+  const bool on_disk = Vfs::current().on_disk();
+  Uring ring(on_disk ? default_uring_entries : 0);
+  bool success = create_folders(ring);
+
+  IO_Executor executor;
+  const std::string &root = paths::root();
+  std::vector<Task<bool>> tasks;
+  Summary summary;
+  Progress progress("files", files.size());
+  std::pmr::vector<Uring::Write> writes(memory);
+  std::pmr::vector<Op_Type> write_ops(memory);
+  std::pmr::vector<std::string_view> write_paths(memory);
+  std::pmr::vector<iovec> iov(memory);
+  std::pmr::vector<Uring::Entry> removals(memory);
+  std::pmr::vector<std::string_view> removal_paths(memory);
+
+  /* Chains view iov, so it must not grow while they are recorded */
+  size_t fragment_count = 0;
+
+  for (const auto &[path, file] : files)
+    if (ring.available() && batchable(file) && !file.edits.empty())
+      fragment_count += file.edits.front().content.get_fragments().size();
+
+  iov.reserve(fragment_count);
+
+  for (const auto &[path, file] : files) {
+    if (!on_disk) {
+      success =
+          record(apply(path, file), path, file, summary, progress) && success;
+      continue;
+    }
+
+    if (!ring.available() || !batchable(file)) {
+      tasks.push_back(
+          execute_file(executor, root, path, file, summary, progress));
+      continue;
+    }
+
+    const Op_Type op = final_op(file);
+    const directory::At_Path target = directory::at(path);
+
+    if (unchanged(path, file)) {
+      summary.unchanged++;
+      progress.advance(path);
+      continue;
+    }
+
+    if (op == Op_Type::remove) {
+      removals.push_back({target.dirfd, target.path});
+      removal_paths.push_back(path);
+      continue;
+    }
+
+    const size_t first = iov.size();
+    size_t size = 0;
+
+    if (op != Op_Type::create) {
+      for (const auto &fragment : file.edits.front().content.get_fragments())
+        iov.push_back({const_cast<char *>(fragment.data()), fragment.size()});
+
+      size = file.edits.front().content.size();
+    }
+
+    writes.push_back({target.dirfd, target.path,
+                      O_WRONLY | O_CREAT | (file.truncated ? O_TRUNC : 0) |
+                          (op == Op_Type::append ? O_APPEND : 0),
+                      std::span(iov).subspan(first), size});
+    write_ops.push_back(op);
+    write_paths.push_back(path);
+  }
+
+  /* Submitted in slices, so progress moves while the ring works */
+  for (size_t start = 0; start < writes.size(); start += progress_slice) {
+    const size_t end = std::min(start + progress_slice, writes.size());
+    ring.write_files(std::span(writes).subspan(start, end - start));
+
+    for (size_t i = start; i < end; i++) {
+      progress.advance(write_paths[i]);
+
+      if (writes[i].error == 0)
+        summary.written++;
+      else {
+        log_failure(write_ops[i], write_paths[i]);
+        success = false;
+      }
+    }
+  }
+
+  ring.remove_files(removals);
+
+  for (size_t i = 0; i < removals.size(); i++) {
+    progress.advance(removal_paths[i]);
+
+    if (removals[i].error == 0)
+      summary.removed++;
+    else {
+      log_failure(Op_Type::remove, removal_paths[i]);
+      success = false;
+    }
+  }
+
+  success = executor.run(when_all(std::move(tasks))) && success;
+  progress.finish();
+  file_index::forget(); // Folders changed, it is checked again
+  directory::forget_extension();
+
+  if (!files.empty())
+    logger.custom(std::to_string(summary.written) + " written, " +
+                      std::to_string(summary.unchanged) + " unchanged" +
+                      (summary.removed != 0
+                           ? ", " + std::to_string(summary.removed) +
+                                 " removed"
+                           : ""),
+                  "files", "theme");
+
+  if (success && !success_message.empty())
+    logger.success(std::string(success_message));
+
+  return success;
+}
@@ -0,0 +1,185 @@
+/**
+ * @file process.cpp
+ * @brief Runs external programs and captures their output in memory
+ * @version 0.1
+ * @date 2025-03-09
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#include "../include/process.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+extern char **environ;
+
+namespace process {
+/**
+ * @brief Spawns program (searched for in PATH, no shell involved) and captures
+ * its stdout and stderr through pipes
+ *
+ * @param argv Program followed by its arguments
+ * @param timeout Time after which program is killed (zero waits forever)
+ * @return Result
+ */
+Result run(const std::vector<std::string> &argv,
+           const std::chrono::milliseconds &timeout) {
+  Result result;
+
+  if (argv.empty())
+    return result;
+
+  int out_pipe[2], err_pipe[2];
+
+  if (pipe2(out_pipe, O_CLOEXEC) != 0) {
+    result.err = std::strerror(errno);
+    return result;
+  }
+
+  if (pipe2(err_pipe, O_CLOEXEC) != 0) {
+    result.err = std::strerror(errno);
+    close(out_pipe[0]);
+    close(out_pipe[1]);
+    return result;
+  }
+
+  /* Child writes straight into the pipes (dup2 clears O_CLOEXEC) */
+  posix_spawn_file_actions_t actions;
+  posix_spawn_file_actions_init(&actions);
+  posix_spawn_file_actions_adddup2(&actions, out_pipe[1], STDOUT_FILENO);
+  posix_spawn_file_actions_adddup2(&actions, err_pipe[1], STDERR_FILENO);
+
+  std::vector<char *> c_argv;
+  c_argv.reserve(argv.size() + 1);
+
+  for (const auto &arg : argv)
+    c_argv.push_back(const_cast<char *>(arg.c_str()));
+
+  c_argv.push_back(nullptr);
+
+  pid_t pid;
+  const int spawn_status = posix_spawnp(&pid, c_argv[0], &actions, nullptr,
+                                        c_argv.data(), environ);
+
+  posix_spawn_file_actions_destroy(&actions);
+  close(out_pipe[1]);
+  close(err_pipe[1]);
+
+  if (spawn_status != 0) {
+    result.err = std::strerror(spawn_status);
+    close(out_pipe[0]);
+    close(err_pipe[0]);
+    return result;
+  }
+
+  /* Drain both pipes until child closes them or deadline passes */
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  std::array<pollfd, 2> fds = {{
+      {out_pipe[0], POLLIN, 0},
+      {err_pipe[0], POLLIN, 0},
+  }};
+  std::array<std::string *, 2> sinks = {&result.out, &result.err};
+  std::array<char, 4096> buffer;
+  size_t open_fds = fds.size();
+
+  while (open_fds > 0) {
+    int wait_ms = -1;
+
+    if (timeout.count() > 0) {
+      const auto remaining =
+          std::chrono::duration_cast<std::chrono::milliseconds>(
+              deadline - std::chrono::steady_clock::now());
+
+      if (remaining.count() <= 0) {
+        result.timed_out = true;
+        break;
+      }
+
+      wait_ms = static_cast<int>(remaining.count());
+    }
+
+    if (poll(fds.data(), fds.size(), wait_ms) < 0) {
+      if (errno == EINTR)
+        continue;
+
+      break;
+    }
+
+    for (size_t i = 0; i < fds.size(); i++) {
+      if (fds[i].fd < 0 || fds[i].revents == 0)
+        continue;
+
+      const ssize_t n = read(fds[i].fd, buffer.data(), buffer.size());
+
+      if (n > 0) {
+        sinks[i]->append(buffer.data(), n);
+        continue;
+      }
+
+      if (n < 0 && errno == EINTR)
+        continue;
+
+      close(fds[i].fd);
+      fds[i].fd = -1;
+      open_fds--;
+    }
+  }
+
+  for (const auto &fd : fds)
+    if (fd.fd >= 0)
+      close(fd.fd);
+
+  /* Exit status (a child that closed its pipes is still held to the
+   * deadline) */
+  int status = 0;
+  pid_t waited = 0;
+  std::chrono::milliseconds step(1); // Doubled up to 10ms between checks
+
+  while (timeout.count() > 0 && !result.timed_out) {
+    waited = waitpid(pid, &status, WNOHANG);
+
+    if (waited > 0 || (waited < 0 && errno != EINTR))
+      break;
+
+    const auto remaining =
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now());
+
+    if (remaining.count() <= 0)
+      result.timed_out = true;
+    else {
+      std::this_thread::sleep_for(std::min(remaining, step));
+      step = std::min(step * 2, std::chrono::milliseconds(10));
+    }
+  }
+
+  if (result.timed_out)
+    kill(pid, SIGKILL);
+
+  while (waited == 0 || (waited < 0 && errno == EINTR))
+    waited = waitpid(pid, &status, 0);
+
+  /* Without a status the exit code is unknown, it's never reported as 0 */
+  if (waited < 0) {
+    result.err += "could not wait for " + argv[0] + ": " + std::strerror(errno);
+    return result;
+  }
+
+  if (WIFEXITED(status))
+    result.exit_code = WEXITSTATUS(status);
+  else if (WIFSIGNALED(status))
+    result.exit_code = 128 + WTERMSIG(status);
+
+  return result;
+}
+} // namespace process
\ No newline at end of file
@@ -0,0 +1,161 @@
+/**
+ * @file progress.cpp
+ * @brief Gives functionality to progress.h
+ * @version 0.1
+ * @date 2025-05-11
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#include "../include/progress.h"
+#include "../include/logger.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+namespace {
+Logger &logger = Logger::get();
+
+constexpr std::string_view progress_prefix = "[progress]: ";
+
+/**
+ * @brief Formats duration as [h]h[m]m[s]s, leaving out leading zero units
+ *
+ * @param seconds Duration
+ * @return std::string
+ */
+std::string format_duration(size_t seconds) {
+  std::string text;
+
+  if (seconds >= 3600)
+    text += std::to_string(seconds / 3600) + "h";
+
+  if (seconds >= 60)
+    text += std::to_string(seconds / 60 % 60) + "m";
+
+  return text + std::to_string(seconds % 60) + "s";
+}
+} // namespace
+
+/**
+ * @brief Construct a new Progress object (disabled if stdout is not a
+ * terminal, lines go to a sink or another status line is already shown)
+ *
+ * @param _label What is counted
+ * @param _total Number of items
+ */
+Progress::Progress(std::string_view _label, size_t _total)
+    : label(_label), total(_total), start(Clock::now()), last_draw(start) {
+  const char *const term = std::getenv("TERM");
+
+  enabled = logger.progress() == nullptr && logger.sink() == nullptr &&
+            isatty(STDOUT_FILENO) == 1 &&
+            (term == nullptr || std::string_view(term) != "dumb");
+
+  if (!enabled)
+    return;
+
+  winsize size{};
+
+  if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_col > 0)
+    columns = size.ws_col;
+
+  logger.set_progress(this);
+}
+
+/**
+ * @brief Destroy the Progress object
+ *
+ */
+Progress::~Progress() { finish(); }
+
+/**
+ * @brief Checks if status line is enabled
+ *
+ * @return true
+ * @return false
+ */
+bool Progress::active() const { return enabled; }
+
+/**
+ * @brief Counts finished items, the status line is only redrawn once the
+ * redraw interval passed (so short operations never show it)
+ *
+ * @param _item Item that was just finished
+ * @param done Number of items finished
+ */
+void Progress::advance(std::string_view _item, size_t done) {
+  count += done;
+
+  if (!enabled)
+    return;
+
+  const Clock::time_point now = Clock::now();
+
+  if (now - last_draw < progress_redraw_interval)
+    return;
+
+  last_draw = now;
+  item.assign(_item);
+  draw();
+}
+
+/**
+ * @brief Redraws status line in place, cut to the terminal width so it never
+ * wraps
+ *
+ */
+void Progress::draw() {
+  const double seconds =
+      std::chrono::duration<double>(last_draw - start).count();
+  const double rate = (seconds > 0) ? static_cast<double>(count) / seconds : 0;
+
+  std::string text = std::to_string(count) + "/" + std::to_string(total) +
+                     " " + label + "  " +
+                     std::to_string(static_cast<size_t>(rate)) + "/s";
+
+  if (rate > 0 && count < total)
+    text += "  eta " + format_duration(static_cast<size_t>(
+                           static_cast<double>(total - count) / rate));
+
+  text += "  " + item;
+
+  const size_t width = columns - std::min<size_t>(columns,
+                                                 progress_prefix.size() + 1);
+
+  if (text.size() > width)
+    text.resize(width);
+
+  std::cout << "\r\x1b[2K" << logger.colors["theme"] << progress_prefix
+            << logger.colors["reset"] << text << std::flush;
+  drawn = true;
+}
+
+/**
+ * @brief Erases status line, so a full line can be printed in its place (it
+ * is redrawn with the next item)
+ *
+ */
+void Progress::clear() {
+  if (!drawn)
+    return;
+
+  std::cout << "\r\x1b[2K" << std::flush;
+  drawn = false;
+}
+
+/**
+ * @brief Erases status line for good, Logger prints every line again
+ *
+ */
+void Progress::finish() {
+  if (!enabled)
+    return;
+
+  clear();
+  enabled = false;
+  logger.set_progress(nullptr);
+}
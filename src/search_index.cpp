@@ -0,0 +1,731 @@
+/**
+ * @file search_index.cpp
+ * @brief Trigram index of project sources, narrows cpm find down to the
+ * files that can contain a match
+ * @version 0.1
+ * @date 2025-06-10
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#include "../include/search_index.h"
+#include "../include/emitter.h"
+#include "../include/paths.h"
+#include "../include/tree_walker.h"
+#include "../include/vfs.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstring>
+#include <fcntl.h>
+#include <functional>
+#include <limits>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+
+namespace {
+constexpr std::string_view index_magic = "cpmfind1";
+
+/* Files handed to a worker at a time */
+constexpr size_t files_per_worker = 64;
+
+/* Id of a file that is no longer in the index */
+constexpr uint32_t no_id = std::numeric_limits<uint32_t>::max();
+
+/**
+ * @brief Appends value as a varint (7 bits per byte, low bits first)
+ *
+ * @param out Encoded data
+ * @param value Value
+ */
+void put_varint(std::string &out, uint64_t value) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+
+  out.push_back(static_cast<char>(value));
+}
+
+/**
+ * @brief Reads varint at the start of data
+ *
+ * @param data Encoded data (advanced past the varint)
+ * @param value Decoded value
+ * @return true
+ * @return false if data ends before the varint does
+ */
+bool get_varint(std::string_view &data, uint64_t &value) {
+  value = 0;
+
+  for (int shift = 0; shift < 64 && !data.empty(); shift += 7) {
+    const auto byte = static_cast<uint8_t>(data.front());
+    data.remove_prefix(1);
+    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+
+    if ((byte & 0x80) == 0)
+      return true;
+  }
+
+  return false;
+}
+
+/**
+ * @brief Appends ids as the differences between them
+ *
+ * @param out Encoded data
+ * @param ids Sorted file ids
+ * @param previous Last id already in the posting list (0 for a new one)
+ */
+void encode(std::string &out, std::span<const uint32_t> ids,
+            uint32_t previous) {
+  for (const uint32_t id : ids) {
+    put_varint(out, id - previous);
+    previous = id;
+  }
+}
+
+/**
+ * @brief Decodes posting list
+ *
+ * @param data Encoded posting data
+ * @param list Posting list in data
+ * @param out Sorted file ids
+ */
+void decode(std::string_view data, const search_index::Posting_List &list,
+            std::vector<uint32_t> &out) {
+  std::string_view rest = data.substr(list.offset, list.size);
+  uint64_t delta;
+  uint32_t id = 0;
+
+  out.clear();
+  out.reserve(list.count);
+
+  while (out.size() < list.count && get_varint(rest, delta)) {
+    id += static_cast<uint32_t>(delta);
+    out.push_back(id);
+  }
+}
+
+/**
+ * @brief Runs task for every index in [0, count) on all cores (the calling
+ * thread works too)
+ *
+ * @param count Number of tasks
+ * @param task Task, must only touch the state of its own index
+ */
+void parallel_for(size_t count, const std::function<void(size_t)> &task) {
+  const size_t workers =
+      std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()),
+                       (count + files_per_worker - 1) / files_per_worker);
+  std::atomic<size_t> next = 0;
+
+  const auto work = [&] {
+    for (size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < count;)
+      task(i);
+  };
+
+  std::vector<std::jthread> threads;
+
+  for (size_t i = 1; i < workers; i++)
+    threads.emplace_back(work);
+
+  work();
+}
+
+/**
+ * @brief File as found by an update
+ *
+ */
+struct Scan {
+  search_index::File file;
+  uint32_t old_id = no_id;        // Unchanged file's id in the old index
+  bool found = false;             // Still exists
+  bool known = false;             // Old index has a file at its path
+  std::vector<uint32_t> trigrams; // Of a new or changed text file
+};
+
+/**
+ * @brief Stats file and, if it is new or changed, reads its trigrams (runs
+ * on worker threads, so only absolute paths are used, never the calling
+ * thread's root or filesystem)
+ *
+ * @param absolute Absolute path of file
+ * @param old_files Files of the old index
+ * @param by_path Ids of old files that still exist, sorted by path
+ * @param scan File to fill in
+ */
+void scan_file(const std::string &absolute,
+               std::span<const search_index::File> old_files,
+               std::span<const uint32_t> by_path, Scan &scan) {
+  const int fd = open(absolute.c_str(), O_RDONLY | O_CLOEXEC);
+  struct stat info;
+
+  if (fd < 0)
+    return;
+
+  if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+    close(fd);
+    return;
+  }
+
+  scan.found = true;
+  scan.file.modified = {info.st_mtim.tv_sec, info.st_mtim.tv_nsec};
+  scan.file.size = static_cast<uint64_t>(info.st_size);
+
+  const auto old = std::ranges::lower_bound(
+      by_path, scan.file.path, {},
+      [&](uint32_t id) -> const std::string & { return old_files[id].path; });
+
+  if (old != by_path.end() && old_files[*old].path == scan.file.path) {
+    const search_index::File &file = old_files[*old];
+    scan.known = true;
+
+    if (file.modified == scan.file.modified && file.size == scan.file.size) {
+      scan.old_id = *old;
+      scan.file.text = file.text;
+      close(fd);
+      return;
+    }
+  }
+
+  std::string contents;
+
+  if (scan.file.size <= search_index::max_file_size) {
+    contents.resize(scan.file.size);
+    size_t done = 0;
+
+    while (done < contents.size()) {
+      const ssize_t size =
+          read(fd, contents.data() + done, contents.size() - done);
+
+      if (size <= 0)
+        break;
+
+      done += static_cast<size_t>(size);
+    }
+
+    contents.resize(done);
+    scan.file.text =
+        std::memchr(contents.data(), '\0', contents.size()) == nullptr;
+  }
+
+  close(fd);
+
+  if (scan.file.text)
+    search_index::trigrams(contents, scan.trigrams);
+}
+} // namespace
+
+namespace search_index {
+/**
+ * @brief Folds ASCII letters to lower case (the index is case-insensitive,
+ * matches are checked against the file afterwards)
+ *
+ * @param c Character
+ * @return char
+ */
+char fold(char c) { return (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c; }
+
+/**
+ * @brief Gets every trigram of text that doesn't span a line break
+ *
+ * @param text Text
+ * @param out Folded trigrams (sorted, without duplicates)
+ */
+void trigrams(std::string_view text, std::vector<uint32_t> &out) {
+  /* One bit per trigram, only the words text set are cleared afterwards */
+  thread_local std::vector<uint64_t> seen((size_t(1) << 24) / 64);
+
+  const auto byte = [&](size_t i) {
+    return static_cast<uint32_t>(static_cast<uint8_t>(fold(text[i])));
+  };
+
+  out.clear();
+
+  for (size_t i = 0; i + 2 < text.size(); i++) {
+    if (text[i] == '\n' || text[i + 1] == '\n' || text[i + 2] == '\n')
+      continue;
+
+    const uint32_t trigram = byte(i) << 16 | byte(i + 1) << 8 | byte(i + 2);
+    uint64_t &word = seen[trigram / 64];
+    const uint64_t bit = uint64_t(1) << (trigram % 64);
+
+    if ((word & bit) == 0) {
+      word |= bit;
+      out.push_back(trigram);
+    }
+  }
+
+  for (const uint32_t trigram : out)
+    seen[trigram / 64] = 0;
+
+  std::ranges::sort(out);
+}
+
+/**
+ * @brief Gets trigrams every match of pattern contains, a regular expression
+ * contributes the literal runs outside groups and classes that no quantifier
+ * makes optional (top-level alternatives contribute none)
+ *
+ * @param pattern Text or regular expression (ECMAScript)
+ * @param regex Pattern is a regular expression
+ * @return std::vector<uint32_t> (empty if every text file must be searched)
+ */
+std::vector<uint32_t> required_trigrams(std::string_view pattern,
+                                        const bool &regex) {
+  std::vector<std::string> runs;
+
+  if (!regex)
+    runs.emplace_back(pattern);
+  else {
+    std::string run;
+    size_t depth = 0;
+    bool in_class = false;
+    bool last_literal = false; // Last character was appended to run
+
+    const auto flush = [&] {
+      if (run.size() >= 3)
+        runs.push_back(run);
+
+      run.clear();
+      last_literal = false;
+    };
+
+    for (size_t i = 0; i < pattern.size(); i++) {
+      const char c = pattern[i];
+
+      if (in_class) {
+        if (c == '\\')
+          i++;
+        else if (c == ']')
+          in_class = false;
+
+        continue;
+      }
+
+      if (c == '\\' && i + 1 < pattern.size()) {
+        const char escaped = pattern[++i];
+
+        if (std::isalnum(static_cast<unsigned char>(escaped))) {
+          /* Character classes, anchors, back references and codes */
+          i += (escaped == 'x') ? 2 : (escaped == 'u') ? 4 : 0;
+          i += (escaped == 'c') ? 1 : 0;
+          flush();
+        } else if (depth == 0) {
+          run.push_back(escaped);
+          last_literal = true;
+        }
+
+        continue;
+      }
+
+      switch (c) {
+      case '|':
+        if (depth == 0)
+          return {};
+        break;
+      case '(':
+        flush();
+        depth++;
+        break;
+      case ')':
+        flush();
+        depth -= (depth > 0) ? 1 : 0;
+        break;
+      case '[':
+        flush();
+        in_class = true;
+        break;
+      case '?':
+      case '*':
+      case '{':
+        /* Character before the quantifier is optional */
+        if (last_literal)
+          run.pop_back();
+
+        flush();
+
+        if (c == '{')
+          while (i < pattern.size() && pattern[i] != '}')
+            i++;
+        break;
+      case '+':
+      case '.':
+      case '^':
+      case '$':
+        flush();
+        break;
+      default:
+        if (depth == 0) {
+          run.push_back(c);
+          last_literal = true;
+        }
+      }
+    }
+
+    flush();
+  }
+
+  std::vector<uint32_t> required, run_trigrams;
+
+  for (const auto &run : runs) {
+    trigrams(run, run_trigrams);
+    required.insert(required.end(), run_trigrams.begin(), run_trigrams.end());
+  }
+
+  std::ranges::sort(required);
+  required.erase(std::unique(required.begin(), required.end()), required.end());
+  return required;
+}
+
+/**
+ * @brief Reads index from its file (posting lists stay encoded until a
+ * search needs them)
+ *
+ * @return true
+ * @return false if there is none or it isn't readable
+ */
+bool Index::load() {
+  std::string data;
+
+  if (!Vfs::current().read(index_path, data) || !data.starts_with(index_magic))
+    return false;
+
+  std::string_view rest = std::string_view(data).substr(index_magic.size());
+  uint64_t count, value;
+  std::vector<File> loaded_files;
+
+  if (!get_varint(rest, count))
+    return false;
+
+  for (uint64_t i = 0; i < count; i++) {
+    File file;
+
+    if (!get_varint(rest, value) || value > rest.size())
+      return false;
+
+    file.path = rest.substr(0, value);
+    rest.remove_prefix(value);
+
+    uint64_t seconds, nanoseconds, text;
+
+    if (!get_varint(rest, seconds) || !get_varint(rest, nanoseconds) ||
+        !get_varint(rest, file.size) || !get_varint(rest, text))
+      return false;
+
+    file.modified = {static_cast<int64_t>(seconds),
+                     static_cast<int64_t>(nanoseconds)};
+    file.text = text != 0;
+    loaded_files.push_back(std::move(file));
+  }
+
+  std::vector<Posting_List> loaded_lists;
+  uint32_t trigram = 0;
+  size_t offset = 0;
+
+  if (!get_varint(rest, count))
+    return false;
+
+  for (uint64_t i = 0; i < count; i++) {
+    uint64_t delta, ids, size;
+
+    if (!get_varint(rest, delta) || !get_varint(rest, ids) ||
+        !get_varint(rest, size))
+      return false;
+
+    trigram += static_cast<uint32_t>(delta);
+    loaded_lists.push_back({trigram, static_cast<uint32_t>(ids), offset, size});
+    offset += size;
+  }
+
+  if (offset != rest.size())
+    return false; // Cut short
+
+  data.erase(0, data.size() - rest.size());
+  postings = std::move(data);
+  lists = std::move(loaded_lists);
+  files = std::move(loaded_files);
+  return true;
+}
+
+/**
+ * @brief Writes index to its file (renamed into place, readers never see
+ * half of it)
+ *
+ * @return true
+ * @return false
+ */
+bool Index::save() const {
+  std::string header(index_magic);
+  put_varint(header, files.size());
+
+  for (const auto &file : files) {
+    put_varint(header, file.path.size());
+    header += file.path;
+    put_varint(header, static_cast<uint64_t>(file.modified.seconds));
+    put_varint(header, static_cast<uint64_t>(file.modified.nanoseconds));
+    put_varint(header, file.size);
+    put_varint(header, file.text ? 1 : 0);
+  }
+
+  put_varint(header, lists.size());
+  uint32_t previous = 0;
+
+  for (const auto &list : lists) {
+    put_varint(header, list.trigram - previous);
+    put_varint(header, list.count);
+    put_varint(header, list.size);
+    previous = list.trigram;
+  }
+
+  Emitter content;
+  content.append({header, postings});
+
+  Vfs &vfs = Vfs::current();
+  return vfs.make_folders(paths::parent(index_path)) &&
+         vfs.replace(index_path, content);
+}
+
+/**
+ * @brief Brings index up to date with the files in indexed_folders (what
+ * .gitignore files ignore is left out), files are walked, stated and, if new
+ * or changed, read on all cores
+ *
+ * New and changed files get new ids, the ids of changed and removed files
+ * die. Posting lists are only appended to, so unchanged ones are copied as
+ * they are, dead ids are dropped once a quarter of the ids is dead.
+ *
+ * @return size_t Number of files read again or removed
+ */
+size_t Index::update() {
+  std::vector<Scan> scans;
+  Walk_Options options;
+  options.gitignore = true;
+
+  for (const auto folder : indexed_folders)
+    Tree_Walker(options).walk(folder, [&](const Walk_Entry &entry) {
+      Scan &scan = scans.emplace_back();
+      scan.file.path.append(folder).append("/").append(entry.path);
+      return true;
+    });
+
+  std::ranges::sort(scans, {}, [](const Scan &scan) -> const std::string & {
+    return scan.file.path;
+  });
+
+  const std::string &root = paths::root();
+  std::vector<std::string> absolute(scans.size());
+  std::vector<uint32_t> by_path;
+
+  for (size_t i = 0; i < scans.size(); i++)
+    absolute[i] = root + "/" + scans[i].file.path;
+
+  for (size_t id = 0; id < files.size(); id++)
+    if (!files[id].path.empty())
+      by_path.push_back(static_cast<uint32_t>(id));
+
+  std::ranges::sort(by_path, {}, [&](uint32_t id) -> const std::string & {
+    return files[id].path;
+  });
+
+  parallel_for(scans.size(), [&](size_t i) {
+    scan_file(absolute[i], files, by_path, scans[i]);
+  });
+
+  /* Files that weren't found unchanged die */
+  std::vector<bool> kept(files.size(), false);
+  size_t read = 0, replaced = 0;
+
+  for (const auto &scan : scans) {
+    if (scan.old_id != no_id)
+      kept[scan.old_id] = true;
+    else if (scan.found) {
+      read++;
+      replaced += scan.known ? 1 : 0;
+    }
+  }
+
+  size_t dead = files.size() - by_path.size();
+
+  for (const uint32_t id : by_path)
+    if (!kept[id]) {
+      files[id] = {};
+      dead++;
+    }
+
+  const size_t changed = read + (dead - (files.size() - by_path.size())) -
+                         replaced;
+
+  if (changed == 0)
+    return 0;
+
+  /* New and changed files are appended */
+  std::unordered_map<uint32_t, std::vector<uint32_t>> added;
+
+  for (auto &scan : scans) {
+    if (!scan.found || scan.old_id != no_id)
+      continue;
+
+    const auto id = static_cast<uint32_t>(files.size());
+
+    for (const uint32_t trigram : scan.trigrams)
+      added[trigram].push_back(id);
+
+    scan.trigrams = {};
+    files.push_back(std::move(scan.file));
+  }
+
+  std::vector<uint32_t> added_trigrams;
+  added_trigrams.reserve(added.size());
+
+  for (const auto &[trigram, ids] : added)
+    added_trigrams.push_back(trigram);
+
+  std::ranges::sort(added_trigrams);
+
+  /* Old posting lists (copied as they are) with the new ids appended,
+   * trigram by trigram */
+  std::string new_postings;
+  std::vector<Posting_List> new_lists;
+  std::vector<uint32_t> old_ids;
+  auto old_list = lists.begin();
+  auto added_trigram = added_trigrams.begin();
+
+  new_postings.reserve(postings.size());
+  new_lists.reserve(lists.size());
+
+  while (old_list != lists.end() || added_trigram != added_trigrams.end()) {
+    const bool old_first =
+        added_trigram == added_trigrams.end() ||
+        (old_list != lists.end() && old_list->trigram <= *added_trigram);
+    Posting_List list{old_first ? old_list->trigram : *added_trigram, 0,
+                      new_postings.size(), 0};
+    uint32_t last = 0;
+
+    if (old_list != lists.end() && old_list->trigram == list.trigram) {
+      new_postings.append(postings, old_list->offset, old_list->size);
+      list.count = old_list->count;
+
+      if (added_trigram != added_trigrams.end() &&
+          *added_trigram == list.trigram) {
+        decode(postings, *old_list, old_ids);
+        last = old_ids.empty() ? 0 : old_ids.back();
+      }
+
+      ++old_list;
+    }
+
+    if (added_trigram != added_trigrams.end() &&
+        *added_trigram == list.trigram) {
+      const std::vector<uint32_t> &ids = added[*added_trigram++];
+      encode(new_postings, ids, last);
+      list.count += static_cast<uint32_t>(ids.size());
+    }
+
+    list.size = new_postings.size() - list.offset;
+    new_lists.push_back(list);
+  }
+
+  postings = std::move(new_postings);
+  lists = std::move(new_lists);
+
+  if (dead * 4 > files.size())
+    compact();
+
+  return changed;
+}
+
+/**
+ * @brief Drops dead ids, the files left are numbered again in their order
+ *
+ */
+void Index::compact() {
+  std::vector<uint32_t> new_ids(files.size(), no_id);
+  std::vector<File> live_files;
+
+  for (size_t id = 0; id < files.size(); id++) {
+    if (files[id].path.empty())
+      continue;
+
+    new_ids[id] = static_cast<uint32_t>(live_files.size());
+    live_files.push_back(std::move(files[id]));
+  }
+
+  std::string new_postings;
+  std::vector<Posting_List> new_lists;
+  std::vector<uint32_t> old_ids, ids;
+
+  for (const auto &list : lists) {
+    decode(postings, list, old_ids);
+    ids.clear();
+
+    for (const uint32_t id : old_ids)
+      if (new_ids[id] != no_id)
+        ids.push_back(new_ids[id]);
+
+    if (ids.empty())
+      continue;
+
+    const size_t offset = new_postings.size();
+    encode(new_postings, ids, 0);
+    new_lists.push_back({list.trigram, static_cast<uint32_t>(ids.size()),
+                         offset, new_postings.size() - offset});
+  }
+
+  postings = std::move(new_postings);
+  lists = std::move(new_lists);
+  files = std::move(live_files);
+}
+
+/**
+ * @brief Gets files containing every trigram (rarest posting list first, so
+ * the intersection shrinks as early as possible)
+ *
+ * @param trigrams Trigrams (folded)
+ * @return std::vector<uint32_t> Sorted file ids (every text file if there
+ * are no trigrams)
+ */
+std::vector<uint32_t>
+Index::candidates(std::span<const uint32_t> trigrams) const {
+  std::vector<uint32_t> result;
+
+  if (trigrams.empty()) {
+    for (size_t id = 0; id < files.size(); id++)
+      if (files[id].text)
+        result.push_back(static_cast<uint32_t>(id));
+
+    return result;
+  }
+
+  std::vector<const Posting_List *> needed;
+
+  for (const uint32_t trigram : trigrams) {
+    const auto list =
+        std::ranges::lower_bound(lists, trigram, {}, &Posting_List::trigram);
+
+    if (list == lists.end() || list->trigram != trigram)
+      return {};
+
+    needed.push_back(&*list);
+  }
+
+  std::ranges::sort(needed, {}, &Posting_List::count);
+  decode(postings, *needed.front(), result);
+
+  std::vector<uint32_t> ids, common;
+
+  for (size_t i = 1; i < needed.size() && !result.empty(); i++) {
+    decode(postings, *needed[i], ids);
+    common.clear();
+    std::ranges::set_intersection(result, ids, std::back_inserter(common));
+    result.swap(common);
+  }
+
+  std::erase_if(result, [&](uint32_t id) { return files[id].path.empty(); });
+  return result;
+}
+} // namespace search_index
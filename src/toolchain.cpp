@@ -0,0 +1,102 @@
+/**
+ * @file toolchain.cpp
+ * @brief Detects installed build tools (results are cached in config)
+ * @version 0.1
+ * @date 2025-03-09
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#include "../include/toolchain.h"
+#include "../include/data.h"
+#include "../include/logger.h"
+#include "../include/misc.h"
+
+#include <cstdlib>
+#include <string_view>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace toolchain {
+/**
+ * @brief Finds program in PATH
+ *
+ * @param name Program name
+ * @return std::filesystem::path (empty if program could not be found)
+ */
+std::filesystem::path find_program(const std::string &name) {
+  const char *path_env = std::getenv("PATH");
+
+  if (!path_env)
+    return {};
+
+  std::string_view dirs(path_env);
+
+  while (!dirs.empty()) {
+    const size_t end = dirs.find(':');
+    const std::string_view dir = dirs.substr(0, end);
+    dirs.remove_prefix(end == std::string_view::npos ? dirs.size() : end + 1);
+
+    const std::filesystem::path candidate =
+        std::filesystem::path(dir.empty() ? "." : dir) / name;
+    struct stat info;
+
+    if (stat(candidate.c_str(), &info) == 0 && S_ISREG(info.st_mode) &&
+        access(candidate.c_str(), X_OK) == 0)
+      return std::filesystem::absolute(candidate);
+  }
+
+  return {};
+}
+
+/**
+ * @brief Gets version of installed CMake, only running cmake --version if the
+ * resolved binary changed since the last cached probe
+ *
+ * @return std::string (empty if CMake could not be found or parsed)
+ */
+std::string get_cmake_version() {
+  Logger &logger = Logger::get();
+  Data_Manager &data_manager = Data_Manager::get();
+
+  const std::filesystem::path cmake_path = find_program("cmake");
+  struct stat info;
+
+  if (cmake_path.empty() || stat(cmake_path.c_str(), &info) != 0) {
+    logger.error_q("could not be found in PATH", "cmake");
+    return "";
+  }
+
+  /* Binary is identified by its path, size and modification time */
+  const std::string stamp =
+      std::to_string(info.st_size) + ":" + std::to_string(info.st_mtim.tv_sec) +
+      "." + std::to_string(info.st_mtim.tv_nsec);
+
+  if (data_manager.get_value("cmake_path") == cmake_path.string() &&
+      data_manager.get_value("cmake_stamp") == stamp &&
+      data_manager.config_has_key("cmake_version"))
+    return data_manager.get_value("cmake_version");
+
+  /* Probe binary */
+  const process::Result result =
+      logger.execute({cmake_path.string(), "--version"},
+                     std::chrono::seconds(10));
+
+  if (result.exit_code != 0)
+    return "";
+
+  const std::vector<std::string> version_line =
+      misc::split_string(result.out.substr(0, result.out.find('\n')), " ");
+
+  if (version_line.size() < 3) {
+    logger.error_q("could not be parsed", "cmake --version");
+    return "";
+  }
+
+  data_manager.set_value("cmake_path", cmake_path.string());
+  data_manager.set_value("cmake_stamp", stamp);
+  data_manager.set_value("cmake_version", version_line[2]);
+
+  return version_line[2];
+}
+} // namespace toolchain
\ No newline at end of file
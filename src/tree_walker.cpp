@@ -0,0 +1,516 @@
+/**
+ * @file tree_walker.cpp
+ * @brief Gives functionality to tree_walker.h
+ * @version 0.1
+ * @date 2025-06-12
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#include "../include/tree_walker.h"
+#include "../include/directory.h"
+#include "../include/misc.h"
+#include "../include/paths.h"
+
+#include <algorithm>
+#include <array>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+/* Bytes of directory entries read per getdents64 call */
+constexpr size_t dirent_buffer_size = 32 * 1024;
+
+/**
+ * @brief Directory entry as read by getdents64, before ignore rules
+ *
+ */
+struct Raw_Entry {
+  std::string name;
+  unsigned char type;
+};
+
+/**
+ * @brief Reads every entry of folder except "." and ".."
+ *
+ * @param fd Folder (opened for reading)
+ * @param out Entries
+ */
+void read_entries(int fd, std::vector<Raw_Entry> &out) {
+  alignas(dirent64) std::array<char, dirent_buffer_size> buffer;
+  long size;
+
+  while ((size = syscall(SYS_getdents64, fd, buffer.data(), buffer.size())) >
+         0) {
+    for (long offset = 0; offset < size;) {
+      const auto *entry =
+          reinterpret_cast<const dirent64 *>(buffer.data() + offset);
+      const std::string_view name(entry->d_name);
+      offset += entry->d_reclen;
+
+      if (name != "." && name != "..")
+        out.push_back({std::string(name), entry->d_type});
+    }
+  }
+}
+
+/**
+ * @brief Resolves type of an entry getdents64 didn't type or that is a
+ * symbolic link (links to folders are DT_LNK, everything else they point to
+ * counts as a file)
+ *
+ * @param fd Folder of entry
+ * @param entry Entry
+ * @return unsigned char (DT_DIR, DT_REG or DT_LNK for a link to a folder)
+ */
+unsigned char resolve_type(int fd, const Raw_Entry &entry) {
+  struct stat info;
+
+  if (entry.type == DT_UNKNOWN) {
+    if (fstatat(fd, entry.name.c_str(), &info, AT_SYMLINK_NOFOLLOW) != 0)
+      return DT_REG;
+
+    if (S_ISDIR(info.st_mode))
+      return DT_DIR;
+
+    if (!S_ISLNK(info.st_mode))
+      return DT_REG;
+  } else if (entry.type != DT_LNK)
+    return (entry.type == DT_DIR) ? DT_DIR : DT_REG;
+
+  return (fstatat(fd, entry.name.c_str(), &info, 0) == 0 &&
+          S_ISDIR(info.st_mode))
+             ? DT_LNK
+             : DT_REG;
+}
+} // namespace
+
+/**
+ * @brief Construct a new Tree_Walker object
+ *
+ * @param _options How trees are walked
+ */
+Tree_Walker::Tree_Walker(const Walk_Options &_options) : options(_options) {}
+
+/**
+ * @brief Checks if the last rule matching path ignores it
+ *
+ * @param rules Rules in effect (outermost .gitignore first)
+ * @param path Path relative to project root
+ * @param name Name of file or folder
+ * @param folder It is a folder
+ * @return true
+ * @return false
+ */
+bool Tree_Walker::ignored(const Ignore_Rules &rules, std::string_view path,
+                         std::string_view name, const bool &folder) const {
+  bool ignore = false;
+
+  for (const auto &rule : *rules) {
+    if (rule.folders_only && !folder)
+      continue;
+
+    std::string_view below = path;
+
+    if (!rule.base.empty()) {
+      if (!below.starts_with(rule.base) || below.size() <= rule.base.size() ||
+          below[rule.base.size()] != '/')
+        continue;
+
+      below.remove_prefix(rule.base.size() + 1);
+    }
+
+    if (misc::glob_match(rule.pattern, rule.anchored ? below : name))
+      ignore = !rule.negated;
+  }
+
+  return ignore;
+}
+
+/**
+ * @brief Reads .gitignore of folder (blank lines, comments, "!" negation,
+ * trailing "/" for folders only, a "/" elsewhere anchors to the folder, "*",
+ * "?" and "**" globs)
+ *
+ * @param dirfd Folder
+ * @param inherited Rules of the folders above
+ * @param folder Folder relative to project root ("" for the root)
+ * @return Ignore_Rules (inherited if there is no .gitignore)
+ */
+Tree_Walker::Ignore_Rules
+Tree_Walker::read_rules(int dirfd, const Ignore_Rules &inherited,
+                        std::string_view folder) const {
+  const int fd = openat(dirfd, ".gitignore", O_RDONLY | O_CLOEXEC);
+
+  if (fd < 0)
+    return inherited;
+
+  std::string text;
+  std::array<char, 4096> buffer;
+  ssize_t size;
+
+  while ((size = read(fd, buffer.data(), buffer.size())) > 0)
+    text.append(buffer.data(), static_cast<size_t>(size));
+
+  close(fd);
+
+  auto rules = std::make_shared<std::vector<Ignore_Rule>>(*inherited);
+
+  for (size_t start = 0; start < text.size();) {
+    const size_t end = std::min(text.find('\n', start), text.size());
+    std::string_view line(text.data() + start, end - start);
+    start = end + 1;
+
+    while (!line.empty() && (line.back() == '\r' || line.back() == ' '))
+      line.remove_suffix(1);
+
+    if (line.empty() || line.front() == '#')
+      continue;
+
+    Ignore_Rule rule;
+    rule.base = folder;
+    rule.negated = line.front() == '!';
+
+    if (rule.negated || line.front() == '\\')
+      line.remove_prefix(1);
+
+    rule.folders_only = line.ends_with('/');
+
+    if (rule.folders_only)
+      line.remove_suffix(1);
+
+    rule.anchored = line.find('/') != std::string_view::npos;
+
+    while (line.starts_with('/'))
+      line.remove_prefix(1);
+
+    if (line.empty())
+      continue;
+
+    rule.pattern = line;
+    rules->push_back(std::move(rule));
+  }
+
+  return rules;
+}
+
+/**
+ * @brief Reads folder, files (and the folder itself if folders are
+ * reported) go to found, folders to be read go to subfolders
+ *
+ * @param folder Folder
+ * @param found Entries found
+ * @param subfolders Folders found (only if the walk is recursive)
+ */
+void Tree_Walker::read_folder(const Folder &folder,
+                              std::vector<Walk_Entry> &found,
+                              std::vector<Folder> &subfolders) const {
+  const int fd =
+      openat(base, folder.path.empty() ? "." : folder.path.c_str(),
+             O_RDONLY | O_DIRECTORY | O_CLOEXEC | O_NOFOLLOW);
+
+  if (fd < 0)
+    return;
+
+  struct stat info;
+
+  if (options.folders && fstat(fd, &info) == 0)
+    found.push_back({folder.path, (folder.depth > 0) ? folder.depth - 1 : 0,
+                     true, info.st_mtim});
+
+  std::vector<Raw_Entry> raw;
+  read_entries(fd, raw);
+
+  /* A .gitignore applies to the folder it is in */
+  Ignore_Rules rules = folder.rules;
+
+  if (options.gitignore &&
+      std::ranges::any_of(raw, [](const Raw_Entry &entry) {
+        return entry.name == ".gitignore";
+      })) {
+    std::string relative = prefix + folder.path;
+
+    if (folder.path.empty() && !relative.empty())
+      relative.pop_back(); // Walked folder, "x/" to "x"
+
+    rules = read_rules(fd, rules, relative);
+  }
+
+  const std::string folder_prefix =
+      folder.path.empty() ? "" : folder.path + "/";
+
+  for (const auto &entry : raw) {
+    const unsigned char type = resolve_type(fd, entry);
+
+    if (type == DT_LNK)
+      continue; // Link to a folder
+
+    const bool is_folder = type == DT_DIR;
+
+    if (is_folder &&
+        (!options.recursive ||
+         directory::skipped_folder(entry.name, folder.depth)))
+      continue;
+
+    std::string path = folder_prefix + entry.name;
+
+    if (options.gitignore &&
+        ignored(rules, prefix + path, entry.name, is_folder))
+      continue;
+
+    if (is_folder)
+      subfolders.push_back({std::move(path), folder.depth + 1, rules});
+    else
+      found.push_back({std::move(path), folder.depth, false, {}});
+  }
+
+  close(fd);
+}
+
+/**
+ * @brief Queues folders at the back of worker's deque
+ *
+ * @param worker Worker
+ * @param subfolders Folders (moved from)
+ */
+void Tree_Walker::push(size_t worker, std::vector<Folder> &subfolders) {
+  if (subfolders.empty())
+    return;
+
+  const size_t count = subfolders.size();
+  pending += count;
+
+  {
+    Worker_Queue &queue = *queues[worker];
+    const std::lock_guard lock(queue.mutex);
+
+    for (auto &folder : subfolders)
+      queue.folders.push_back(std::move(folder));
+  }
+
+  {
+    /* Under the lock, so a worker can't miss it while falling asleep */
+    const std::lock_guard lock(mutex);
+    queued += count;
+  }
+
+  if (count > 1)
+    folders_ready.notify_all();
+  else
+    folders_ready.notify_one();
+}
+
+/**
+ * @brief Takes the newest folder of worker's own deque, or steals the
+ * oldest of another worker's (old folders are near the top of the tree, so
+ * a steal tends to bring a large subtree with it)
+ *
+ * @param worker Worker
+ * @param folder Folder taken
+ * @return true
+ * @return false if every deque is empty
+ */
+bool Tree_Walker::take(size_t worker, Folder &folder) {
+  {
+    Worker_Queue &own = *queues[worker];
+    const std::lock_guard lock(own.mutex);
+
+    if (!own.folders.empty()) {
+      folder = std::move(own.folders.back());
+      own.folders.pop_back();
+      queued--;
+      return true;
+    }
+  }
+
+  for (size_t i = 1; i < queues.size(); i++) {
+    Worker_Queue &victim = *queues[(worker + i) % queues.size()];
+    const std::lock_guard lock(victim.mutex);
+
+    if (!victim.folders.empty()) {
+      folder = std::move(victim.folders.front());
+      victim.folders.pop_front();
+      queued--;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/**
+ * @brief Worker loop, runs until every folder was read or the walk stopped
+ *
+ * @param worker Worker
+ */
+void Tree_Walker::work(size_t worker) {
+  Folder folder;
+  std::vector<Walk_Entry> found;
+  std::vector<Folder> subfolders;
+
+  while (!stopped) {
+    if (!take(worker, folder)) {
+      std::unique_lock lock(mutex);
+      folders_ready.wait(
+          lock, [this] { return stopped || pending == 0 || queued > 0; });
+
+      if (stopped || pending == 0)
+        return;
+
+      continue;
+    }
+
+    found.clear();
+    subfolders.clear();
+    read_folder(folder, found, subfolders);
+    push(worker, subfolders);
+
+    bool done;
+
+    {
+      const std::lock_guard lock(mutex);
+      entries.insert(entries.end(), std::make_move_iterator(found.begin()),
+                     std::make_move_iterator(found.end()));
+      done = --pending == 0;
+    }
+
+    entries_ready.notify_one();
+
+    if (done)
+      folders_ready.notify_all();
+  }
+}
+
+/**
+ * @brief Walks folder, on_entry is called on the calling thread (one entry
+ * at a time, in no particular order) until it returns false
+ *
+ * @param folder Folder to walk
+ * @param on_entry Called with every entry found
+ * @return true
+ * @return false if folder couldn't be opened
+ */
+bool Tree_Walker::walk(
+    const std::filesystem::path &folder,
+    const std::function<bool(const Walk_Entry &)> &on_entry) {
+  const directory::At_Path target = directory::at(folder);
+  base = openat(target.dirfd, target.path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+  if (base < 0)
+    return false;
+
+  /* Rules of the .gitignore files between project root and folder */
+  const std::optional<std::string_view> relative = paths::root_relative(folder);
+  Ignore_Rules rules = std::make_shared<const std::vector<Ignore_Rule>>();
+
+  prefix = (!relative || relative->empty()) ? "" : std::string(*relative) + "/";
+
+  if (options.gitignore && relative && !relative->empty()) {
+    std::string above; // "" for the root
+
+    for (const std::string_view segment : paths::Segments{*relative}) {
+      const std::string absolute =
+          above.empty() ? paths::root() : paths::root() + "/" + above;
+      const int fd = openat(AT_FDCWD, absolute.c_str(),
+                            O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+      if (fd >= 0) {
+        rules = read_rules(fd, rules, above);
+        close(fd);
+      }
+
+      above.append(above.empty() ? "" : "/").append(segment);
+    }
+  }
+
+  /* Walked folder is read on the calling thread, workers only start if it
+   * has folders below it */
+  std::vector<Walk_Entry> found;
+  std::vector<Folder> subfolders;
+  read_folder({"", 0, rules}, found, subfolders);
+
+  const size_t workers =
+      (options.threads != 0)
+          ? options.threads
+          : std::max<size_t>(1, std::thread::hardware_concurrency());
+  bool running = true;
+
+  for (const auto &entry : found)
+    if (!(running = on_entry(entry)))
+      break;
+
+  if (running && workers == 1) {
+    /* Depth first on the calling thread */
+    while (running && !subfolders.empty()) {
+      const Folder next = std::move(subfolders.back());
+      subfolders.pop_back();
+      found.clear();
+      read_folder(next, found, subfolders);
+
+      for (const auto &entry : found)
+        if (!(running = on_entry(entry)))
+          break;
+    }
+  } else if (running && !subfolders.empty()) {
+    queues.clear();
+    stopped = false;
+    queued = 0;
+    pending = 0;
+
+    for (size_t i = 0; i < workers; i++)
+      queues.push_back(std::make_unique<Worker_Queue>());
+
+    /* Spread over every worker, so none starts by stealing */
+    for (size_t i = 0; i < subfolders.size(); i++)
+      queues[i % workers]->folders.push_back(std::move(subfolders[i]));
+
+    queued = subfolders.size();
+    pending = subfolders.size();
+
+    std::vector<std::thread> threads;
+
+    for (size_t i = 0; i < workers; i++)
+      threads.emplace_back(&Tree_Walker::work, this, i);
+
+    std::vector<Walk_Entry> batch;
+
+    while (running) {
+      {
+        std::unique_lock lock(mutex);
+        entries_ready.wait(lock,
+                           [this] { return !entries.empty() || pending == 0; });
+
+        if (entries.empty())
+          break;
+
+        batch.swap(entries);
+      }
+
+      for (const auto &entry : batch)
+        if (!(running = on_entry(entry)))
+          break;
+
+      batch.clear();
+    }
+
+    {
+      const std::lock_guard lock(mutex);
+      stopped = true;
+    }
+
+    folders_ready.notify_all();
+
+    for (auto &thread : threads)
+      thread.join();
+
+    entries.clear();
+  }
+
+  close(base);
+  base = -1;
+  return true;
+}
@@ -0,0 +1,328 @@
+/**
+ * @file uring.cpp
+ * @brief Gives functionality to uring.h
+ * @version 0.1
+ * @date 2025-04-20
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#include "../include/uring.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+/* Steps of a write chain, user_data is file index * chain_steps + step */
+constexpr uint64_t open_step = 0, write_step = 1, close_step = 2;
+constexpr uint64_t chain_steps = 3;
+} // namespace
+
+/**
+ * @brief Construct a new Uring object (check available() before use)
+ *
+ * @param _entries Number of submission queue entries (0 leaves it unavailable)
+ */
+Uring::Uring(unsigned _entries) {
+  if (_entries == 0)
+    return;
+
+  io_uring_params params{};
+  ring_fd = static_cast<int>(syscall(__NR_io_uring_setup, _entries, &params));
+
+  if (ring_fd < 0)
+    return;
+
+  /* Write chains rely on offset -1 meaning the current file position */
+  if (!(params.features & IORING_FEAT_SINGLE_MMAP) ||
+      !(params.features & IORING_FEAT_RW_CUR_POS)) {
+    close_ring();
+    return;
+  }
+
+  entries = params.sq_entries;
+  ring_size = std::max(params.sq_off.array + entries * sizeof(unsigned),
+                       params.cq_off.cqes +
+                           params.cq_entries * sizeof(io_uring_cqe));
+  sqes_size = entries * sizeof(io_uring_sqe);
+
+  void *const ring_map = mmap(nullptr, ring_size, PROT_READ | PROT_WRITE,
+                              MAP_SHARED | MAP_POPULATE, ring_fd,
+                              IORING_OFF_SQ_RING);
+  void *const sqes_map = mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE,
+                              MAP_SHARED | MAP_POPULATE, ring_fd,
+                              IORING_OFF_SQES);
+
+  if (ring_map != MAP_FAILED)
+    ring = ring_map;
+
+  if (sqes_map != MAP_FAILED)
+    sqes = static_cast<io_uring_sqe *>(sqes_map);
+
+  if (ring == nullptr || sqes == nullptr) {
+    close_ring();
+    return;
+  }
+
+  char *const base = static_cast<char *>(ring);
+  sq_tail = reinterpret_cast<unsigned *>(base + params.sq_off.tail);
+  sq_mask = reinterpret_cast<unsigned *>(base + params.sq_off.ring_mask);
+  sq_array = reinterpret_cast<unsigned *>(base + params.sq_off.array);
+  cq_head = reinterpret_cast<unsigned *>(base + params.cq_off.head);
+  cq_tail = reinterpret_cast<unsigned *>(base + params.cq_off.tail);
+  cq_mask = reinterpret_cast<unsigned *>(base + params.cq_off.ring_mask);
+  cqes = reinterpret_cast<io_uring_cqe *>(base + params.cq_off.cqes);
+
+  /* A chain passes the file it opened on through a direct descriptor (a
+   * sparse table needs Linux 5.19) */
+  file_slots = entries / chain_steps;
+
+  io_uring_rsrc_register files{};
+  files.nr = file_slots;
+  files.flags = IORING_RSRC_REGISTER_SPARSE;
+
+  if (syscall(__NR_io_uring_register, ring_fd, IORING_REGISTER_FILES2, &files,
+              sizeof(files)) < 0)
+    close_ring();
+}
+
+/**
+ * @brief Destroy the Uring object
+ *
+ */
+Uring::~Uring() { close_ring(); }
+
+/**
+ * @brief Unmaps and closes ring (it is unavailable afterwards)
+ *
+ */
+void Uring::close_ring() {
+  if (sqes != nullptr)
+    munmap(sqes, sqes_size);
+
+  if (ring != nullptr)
+    munmap(ring, ring_size);
+
+  if (ring_fd >= 0)
+    close(ring_fd);
+
+  sqes = nullptr;
+  ring = nullptr;
+  ring_fd = -1;
+}
+
+/**
+ * @brief Checks if ring was set up
+ *
+ * @return true
+ * @return false
+ */
+bool Uring::available() const { return ring_fd >= 0; }
+
+/**
+ * @brief Queues a cleared submission queue entry (at most entries may be
+ * queued between submissions)
+ *
+ * @param opcode Operation
+ * @param user_data Value passed back with the completion
+ * @return io_uring_sqe&
+ */
+io_uring_sqe &Uring::next_sqe(uint8_t opcode, uint64_t user_data) {
+  /* Only this thread writes the tail, the kernel reads it on submission */
+  const unsigned tail = *sq_tail;
+  const unsigned index = tail & *sq_mask;
+
+  io_uring_sqe &sqe = sqes[index];
+  std::memset(&sqe, 0, sizeof(sqe));
+  sqe.opcode = opcode;
+  sqe.user_data = user_data;
+
+  sq_array[index] = index;
+  std::atomic_ref<unsigned>(*sq_tail).store(tail + 1,
+                                            std::memory_order_release);
+  queued++;
+
+  return sqe;
+}
+
+/**
+ * @brief Submits queued entries and waits for all of their completions (the
+ * ring is closed if the kernel refuses the submission)
+ *
+ * @tparam Callback void(uint64_t user_data, int32_t result)
+ * @param on_complete Called for every completion
+ * @return true
+ * @return false
+ */
+template <typename Callback> bool Uring::submit_and_wait(Callback on_complete) {
+  const unsigned pending = queued;
+  unsigned submitted = 0, completed = 0;
+  queued = 0;
+
+  while (completed < pending) {
+    const long result =
+        syscall(__NR_io_uring_enter, ring_fd, pending - submitted,
+                pending - completed, IORING_ENTER_GETEVENTS, nullptr, 0);
+
+    if (result < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+      close_ring();
+      return false;
+    }
+
+    if (result > 0)
+      submitted += static_cast<unsigned>(result);
+
+    unsigned head = *cq_head;
+    const unsigned tail =
+        std::atomic_ref<unsigned>(*cq_tail).load(std::memory_order_acquire);
+
+    for (; head != tail; head++, completed++) {
+      const io_uring_cqe &cqe = cqes[head & *cq_mask];
+      on_complete(cqe.user_data, cqe.res);
+    }
+
+    std::atomic_ref<unsigned>(*cq_head).store(head, std::memory_order_release);
+  }
+
+  return true;
+}
+
+/**
+ * @brief Submits one entry per path, at most entries per submission
+ *
+ * @param targets Paths (errors are stored in them)
+ * @param opcode Operation
+ * @param mode Value of len (directory mode for MKDIRAT)
+ * @param ignored_error errno that counts as success
+ * @return true if every operation succeeded
+ * @return false
+ */
+bool Uring::submit_each(std::span<Entry> targets, uint8_t opcode,
+                        uint32_t mode, int ignored_error) {
+  bool success = true;
+
+  for (size_t start = 0; start < targets.size(); start += entries) {
+    const size_t end = std::min<size_t>(start + entries, targets.size());
+
+    for (size_t i = start; i < end; i++) {
+      io_uring_sqe &sqe = next_sqe(opcode, i);
+      sqe.fd = targets[i].dirfd;
+      sqe.addr = reinterpret_cast<uint64_t>(targets[i].path);
+      sqe.len = mode;
+      targets[i].error = EIO; // Overwritten by the completion
+    }
+
+    if (!submit_and_wait([&](uint64_t i, int32_t result) {
+          targets[i].error =
+              (result < 0 && result != -ignored_error) ? -result : 0;
+        }))
+      return false;
+
+    for (size_t i = start; i < end; i++)
+      success = success && targets[i].error == 0;
+  }
+
+  return success;
+}
+
+/**
+ * @brief Creates directories concurrently (parents must already exist, so
+ * deeper directories go in a later call), existing directories are fine
+ *
+ * @param folders Directories (errors are stored in them)
+ * @return true if every directory exists
+ * @return false
+ */
+bool Uring::make_folders(std::span<Entry> folders) {
+  return submit_each(folders, IORING_OP_MKDIRAT, 0755, EEXIST);
+}
+
+/**
+ * @brief Removes files concurrently, missing files are fine
+ *
+ * @param files Files (errors are stored in them)
+ * @return true if none of the files exist
+ * @return false
+ */
+bool Uring::remove_files(std::span<Entry> files) {
+  return submit_each(files, IORING_OP_UNLINKAT, 0, ENOENT);
+}
+
+/**
+ * @brief Writes files with linked open -> write -> close chains, one batch of
+ * chains per submission
+ *
+ * @param files Files (errors are stored in them)
+ * @return true if every file was written
+ * @return false
+ */
+bool Uring::write_files(std::span<Write> files) {
+  bool success = true;
+
+  for (size_t start = 0; start < files.size(); start += file_slots) {
+    const size_t end = std::min<size_t>(start + file_slots, files.size());
+
+    for (size_t i = start; i < end; i++) {
+      Write &file = files[i];
+      const unsigned slot = static_cast<unsigned>(i - start);
+      file.error = 0;
+
+      /* A failed open cancels the rest of its chain */
+      io_uring_sqe &open_sqe =
+          next_sqe(IORING_OP_OPENAT, i * chain_steps + open_step);
+      open_sqe.fd = file.dirfd;
+      open_sqe.addr = reinterpret_cast<uint64_t>(file.path);
+      open_sqe.len = 0644;
+      open_sqe.open_flags = static_cast<uint32_t>(file.flags);
+      open_sqe.file_index = slot + 1;
+      open_sqe.flags = IOSQE_IO_LINK;
+
+      /* A failed write still closes its descriptor */
+      if (!file.iov.empty()) {
+        io_uring_sqe &write_sqe =
+            next_sqe(IORING_OP_WRITEV, i * chain_steps + write_step);
+        write_sqe.fd = static_cast<int>(slot);
+        write_sqe.addr = reinterpret_cast<uint64_t>(file.iov.data());
+        write_sqe.len = static_cast<uint32_t>(file.iov.size());
+        write_sqe.off = UINT64_MAX; // Current position (end in append mode)
+        write_sqe.flags = IOSQE_FIXED_FILE | IOSQE_IO_HARDLINK;
+      }
+
+      io_uring_sqe &close_sqe =
+          next_sqe(IORING_OP_CLOSE, i * chain_steps + close_step);
+      close_sqe.file_index = slot + 1;
+    }
+
+    const bool submitted = submit_and_wait([&](uint64_t data, int32_t result) {
+      Write &file = files[data / chain_steps];
+
+      /* Cancelled steps follow a failed one, which reports the cause */
+      if (file.error != 0 || result == -ECANCELED)
+        return;
+
+      if (result < 0)
+        file.error = -result;
+      else if (data % chain_steps == write_step &&
+               static_cast<size_t>(result) != file.size)
+        file.error = EIO; // Short write
+    });
+
+    for (size_t i = start; i < end; i++) {
+      if (!submitted && files[i].error == 0)
+        files[i].error = EIO; // Unknown state
+
+      success = success && files[i].error == 0;
+    }
+
+    if (!submitted)
+      return false;
+  }
+
+  return success;
+}
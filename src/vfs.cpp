@@ -0,0 +1,601 @@
+/**
+ * @file vfs.cpp
+ * @brief Gives functionality to vfs.h
+ * @version 0.1
+ * @date 2025-05-04
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#include "../include/vfs.h"
+#include "../include/directory.h"
+#include "../include/file_index.h"
+#include "../include/paths.h"
+#include "../include/tree_walker.h"
+
+#include <array>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+Posix_Vfs posix_vfs;
+thread_local Vfs *current_vfs = &posix_vfs; // Per thread, like the root
+
+/**
+ * @brief Checks if text is made of fragments
+ *
+ * @param text Text
+ * @param fragments Fragments
+ * @param size Total size of fragments
+ * @return true
+ * @return false
+ */
+bool equals_fragments(std::string_view text,
+                      std::span<const std::string_view> fragments,
+                      size_t size) {
+  if (text.size() != size)
+    return false;
+
+  for (const auto &fragment : fragments) {
+    if (!text.starts_with(fragment))
+      return false;
+
+    text.remove_prefix(fragment.size());
+  }
+
+  return true;
+}
+} // namespace
+
+/**
+ * @brief Gets filesystem cpm currently operates on in the calling thread (the
+ * real one unless another was set with use)
+ *
+ * @return Vfs&
+ */
+Vfs &Vfs::current() { return *current_vfs; }
+
+/**
+ * @brief Sets filesystem cpm operates on in the calling thread
+ *
+ * @param vfs Filesystem (nullptr for the real one), must outlive its use
+ */
+void Vfs::use(Vfs *vfs) { current_vfs = (vfs != nullptr) ? vfs : &posix_vfs; }
+
+/**
+ * @brief Checks if operations reach the real filesystem
+ *
+ * @return true
+ */
+bool Posix_Vfs::on_disk() const { return true; }
+
+/**
+ * @brief Checks if directory exists at path
+ *
+ * @param path Path to directory
+ * @return true
+ * @return false
+ */
+bool Posix_Vfs::is_folder(const std::filesystem::path &path) {
+  const directory::At_Path target = directory::at(path);
+  struct stat info;
+
+  return fstatat(target.dirfd, target.path, &info, 0) == 0 &&
+         S_ISDIR(info.st_mode);
+}
+
+/**
+ * @brief Checks if anything exists at path
+ *
+ * @param path Path
+ * @return true
+ * @return false
+ */
+bool Posix_Vfs::exists(const std::filesystem::path &path) {
+  const directory::At_Path target = directory::at(path);
+  struct stat info;
+
+  return fstatat(target.dirfd, target.path, &info, 0) == 0;
+}
+
+/**
+ * @brief Creates directory and its parents (mkdirat for every prefix,
+ * existing ones fail with EEXIST)
+ *
+ * @param path Path to directory
+ * @return true if it exists afterwards
+ * @return false
+ */
+bool Posix_Vfs::make_folders(const std::filesystem::path &path) {
+  const directory::At_Path target = directory::at(path);
+  std::string folder;
+  int error = 0;
+
+  for (const auto &segment : paths::Segments{target.path}) {
+    if (!folder.empty() || target.path[0] == '/')
+      folder += '/';
+
+    folder += segment;
+    error = (mkdirat(target.dirfd, folder.c_str(), 0755) == 0) ? 0 : errno;
+
+    if (error != 0 && error != EEXIST)
+      return false;
+  }
+
+  return error == 0 || is_folder(path);
+}
+
+/**
+ * @brief Reads whole file
+ *
+ * @param path Path to file
+ * @param out String to store contents in
+ * @return true
+ * @return false
+ */
+bool Posix_Vfs::read(const std::filesystem::path &path, std::string &out) {
+  const directory::At_Path target = directory::at(path);
+  const int fd = openat(target.dirfd, target.path, O_RDONLY | O_CLOEXEC);
+
+  if (fd < 0)
+    return false;
+
+  struct stat info;
+  out.clear();
+
+  if (fstat(fd, &info) == 0)
+    out.reserve(static_cast<size_t>(info.st_size));
+
+  std::array<char, 4096> buffer;
+  ssize_t count;
+  bool success = true;
+
+  while ((count = ::read(fd, buffer.data(), buffer.size())) != 0) {
+    if (count > 0)
+      out.append(buffer.data(), static_cast<size_t>(count));
+    else if (errno != EINTR) {
+      success = false;
+      break;
+    }
+  }
+
+  close(fd);
+  return success;
+}
+
+/**
+ * @brief Writes emitted fragments to file
+ *
+ * @param path Path to file
+ * @param content Contents
+ * @param append Append to file instead of overwriting it
+ * @return true
+ * @return false
+ */
+bool Posix_Vfs::write(const std::filesystem::path &path,
+                      const Emitter &content, const bool &append) {
+  const directory::At_Path target = directory::at(path);
+
+  return content.write_to(target.dirfd, target.path, append);
+}
+
+/**
+ * @brief Replaces contents of file, written next to it and renamed over it so
+ * readers never see a partially written file
+ *
+ * @param path Path to file
+ * @param content Contents
+ * @return true
+ * @return false
+ */
+bool Posix_Vfs::replace(const std::filesystem::path &path,
+                        const Emitter &content) {
+  const directory::At_Path target = directory::at(path);
+  const std::string tmp_path = std::string(target.path) + ".tmp";
+
+  return content.write_to(target.dirfd, tmp_path.c_str(), false) &&
+         renameat(target.dirfd, tmp_path.c_str(), target.dirfd, target.path) ==
+             0;
+}
+
+/**
+ * @brief Removes file (a missing file is fine)
+ *
+ * @param path Path to file
+ * @return true
+ * @return false
+ */
+bool Posix_Vfs::remove(const std::filesystem::path &path) {
+  const directory::At_Path target = directory::at(path);
+
+  return unlinkat(target.dirfd, target.path, 0) == 0 || errno == ENOENT;
+}
+
+/**
+ * @brief Checks if file already holds exactly the given fragments (sizes are
+ * compared first, equal sizes are compared through a read-only mapping)
+ *
+ * @param path Path to file
+ * @param fragments Contents
+ * @param size Total size of fragments
+ * @return true
+ * @return false
+ */
+bool Posix_Vfs::same_contents(const std::filesystem::path &path,
+                              std::span<const std::string_view> fragments,
+                              size_t size) {
+  const directory::At_Path target = directory::at(path);
+  struct stat info;
+
+  if (fstatat(target.dirfd, target.path, &info, 0) != 0 ||
+      !S_ISREG(info.st_mode) || static_cast<size_t>(info.st_size) != size)
+    return false;
+
+  if (size == 0)
+    return true;
+
+  const int fd = openat(target.dirfd, target.path, O_RDONLY | O_CLOEXEC);
+
+  if (fd < 0)
+    return false;
+
+  void *const data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+
+  if (data == MAP_FAILED)
+    return false;
+
+  const bool same = equals_fragments(
+      std::string_view(static_cast<const char *>(data), size), fragments,
+      size);
+
+  munmap(data, size);
+  return same;
+}
+
+/**
+ * @brief Lists files in folder (hidden directories and the top-level build
+ * directory are skipped), from the project's file index while it is fresh,
+ * walked on every core otherwise
+ *
+ * @param folder Folder to list
+ * @param recursive List files in sub-directories too
+ * @param on_file Called with path of every file relative to folder
+ */
+void Posix_Vfs::list(
+    const std::filesystem::path &folder, const bool &recursive,
+    const std::function<void(std::string_view relative_path)> &on_file) {
+  if (file_index::list(folder, recursive, on_file))
+    return;
+
+  Walk_Options options;
+  options.recursive = recursive;
+
+  Tree_Walker(options).walk(folder, [&](const Walk_Entry &entry) {
+    on_file(entry.path);
+    return true;
+  });
+}
+
+/**
+ * @brief Construct a new Memory_Vfs object
+ *
+ * @param _lower Filesystem reads fall through to (nullptr for an empty tree)
+ */
+Memory_Vfs::Memory_Vfs(Vfs *_lower)
+    : lower(_lower), files(&arena), folders(&arena), removed(&arena) {}
+
+/**
+ * @brief Checks if file exists at normalized absolute path
+ *
+ * @param key Path
+ * @return true
+ * @return false
+ */
+bool Memory_Vfs::has_file(std::string_view key) {
+  if (files.contains(key))
+    return true;
+
+  if (removed.contains(key) || lower == nullptr)
+    return false;
+
+  const std::filesystem::path path(key);
+
+  return lower->exists(path) && !lower->is_folder(path);
+}
+
+/**
+ * @brief Checks if directory exists at normalized absolute path
+ *
+ * @param key Path
+ * @return true
+ * @return false
+ */
+bool Memory_Vfs::has_folder(std::string_view key) {
+  return folders.contains(key) ||
+         (lower != nullptr && lower->is_folder(std::filesystem::path(key)));
+}
+
+/**
+ * @brief Checks if operations reach the real filesystem
+ *
+ * @return false
+ */
+bool Memory_Vfs::on_disk() const { return false; }
+
+/**
+ * @brief Checks if directory exists at path
+ *
+ * @param path Path to directory
+ * @return true
+ * @return false
+ */
+bool Memory_Vfs::is_folder(const std::filesystem::path &path) {
+  return has_folder(paths::absolute(path));
+}
+
+/**
+ * @brief Checks if anything exists at path
+ *
+ * @param path Path
+ * @return true
+ * @return false
+ */
+bool Memory_Vfs::exists(const std::filesystem::path &path) {
+  const std::string_view key = paths::absolute(path);
+
+  return has_file(key) || has_folder(key);
+}
+
+/**
+ * @brief Creates directory and its parents in memory
+ *
+ * @param path Path to directory
+ * @return true if it exists afterwards
+ * @return false
+ */
+bool Memory_Vfs::make_folders(const std::filesystem::path &path) {
+  std::vector<std::string_view> missing;
+
+  for (std::string_view folder = paths::absolute(path);
+       !folder.empty() && !has_folder(folder);) {
+    if (has_file(folder))
+      return false;
+
+    missing.push_back(folder);
+
+    const std::string_view parent = paths::parent(folder);
+
+    if (parent == folder)
+      break;
+
+    folder = parent;
+  }
+
+  for (const auto &folder : missing)
+    folders.emplace(folder);
+
+  return true;
+}
+
+/**
+ * @brief Reads whole file
+ *
+ * @param path Path to file
+ * @param out String to store contents in
+ * @return true
+ * @return false
+ */
+bool Memory_Vfs::read(const std::filesystem::path &path, std::string &out) {
+  const std::string_view key = paths::absolute(path);
+  const auto file = files.find(std::string_view(key));
+
+  if (file != files.end()) {
+    out.assign(file->second);
+    return true;
+  }
+
+  if (removed.contains(key) || lower == nullptr)
+    return false;
+
+  return lower->read(path, out);
+}
+
+/**
+ * @brief Writes emitted fragments to file in memory (its directory must
+ * exist, like on disk)
+ *
+ * @param path Path to file
+ * @param content Contents
+ * @param append Append to file instead of overwriting it
+ * @return true
+ * @return false
+ */
+bool Memory_Vfs::write(const std::filesystem::path &path,
+                       const Emitter &content, const bool &append) {
+  const std::string_view key = paths::absolute(path);
+
+  if (!has_folder(paths::parent(key)) || has_folder(key))
+    return false;
+
+  auto file = files.find(std::string_view(key));
+
+  if (file == files.end()) {
+    std::string contents;
+
+    if (append && has_file(key))
+      lower->read(path, contents);
+
+    file = files.emplace(key, std::string_view(contents)).first;
+
+    if (const auto hidden = removed.find(std::string_view(key));
+        hidden != removed.end())
+      removed.erase(hidden);
+  } else if (!append)
+    file->second.clear();
+
+  for (const auto &fragment : content.get_fragments())
+    file->second += fragment;
+
+  return true;
+}
+
+/**
+ * @brief Replaces contents of file in memory
+ *
+ * @param path Path to file
+ * @param content Contents
+ * @return true
+ * @return false
+ */
+bool Memory_Vfs::replace(const std::filesystem::path &path,
+                         const Emitter &content) {
+  return write(path, content, false);
+}
+
+/**
+ * @brief Removes file in memory, files of the lower filesystem are hidden
+ * (a missing file is fine)
+ *
+ * @param path Path to file
+ * @return true
+ * @return false
+ */
+bool Memory_Vfs::remove(const std::filesystem::path &path) {
+  const std::string_view key = paths::absolute(path);
+  const auto file = files.find(std::string_view(key));
+
+  if (file != files.end())
+    files.erase(file);
+
+  if (lower != nullptr && lower->exists(path)) {
+    if (lower->is_folder(path))
+      return false;
+
+    removed.emplace(key);
+  }
+
+  return true;
+}
+
+/**
+ * @brief Checks if file already holds exactly the given fragments
+ *
+ * @param path Path to file
+ * @param fragments Contents
+ * @param size Total size of fragments
+ * @return true
+ * @return false
+ */
+bool Memory_Vfs::same_contents(const std::filesystem::path &path,
+                               std::span<const std::string_view> fragments,
+                               size_t size) {
+  const std::string_view key = paths::absolute(path);
+  const auto file = files.find(std::string_view(key));
+
+  if (file != files.end())
+    return equals_fragments(file->second, fragments, size);
+
+  if (removed.contains(key) || lower == nullptr)
+    return false;
+
+  return lower->same_contents(path, fragments, size);
+}
+
+/**
+ * @brief Lists files in folder, files in memory first and then the lower
+ * filesystem's (hidden directories and the top-level build directory are
+ * skipped)
+ *
+ * @param folder Folder to list
+ * @param recursive List files in sub-directories too
+ * @param on_file Called with path of every file relative to folder
+ */
+void Memory_Vfs::list(
+    const std::filesystem::path &folder, const bool &recursive,
+    const std::function<void(std::string_view relative_path)> &on_file) {
+  std::string prefix = paths::absolute(folder);
+
+  if (!prefix.ends_with('/'))
+    prefix += '/';
+
+  /* Files below folder sort directly after prefix */
+  for (auto file = files.lower_bound(std::string_view(prefix));
+       file != files.end() && file->first.starts_with(prefix); file++) {
+    const std::string_view relative_path =
+        std::string_view(file->first).substr(prefix.size());
+
+    if (directory::listed(relative_path, recursive))
+      on_file(relative_path);
+  }
+
+  if (lower == nullptr)
+    return;
+
+  std::string key;
+
+  lower->list(folder, recursive, [&](std::string_view relative_path) {
+    key.assign(prefix).append(relative_path);
+
+    if (!files.contains(std::string_view(key)) &&
+        !removed.contains(std::string_view(key)))
+      on_file(relative_path);
+  });
+}
+
+/**
+ * @brief Gets number of files in memory
+ *
+ * @return size_t
+ */
+size_t Memory_Vfs::file_count() const { return files.size(); }
+
+/**
+ * @brief Writes every directory and file in memory that is inside the
+ * project root to the same relative path below root
+ *
+ * @param root Directory to write to
+ * @param target Filesystem to write to
+ * @return true
+ * @return false
+ */
+bool Memory_Vfs::dump(const std::filesystem::path &root, Vfs &target) const {
+  const std::string &cwd = paths::root();
+  const std::filesystem::path &base = paths::absolute(root);
+  std::string relative;
+  bool success = target.make_folders(base);
+
+  const auto destination = [&](std::string_view key) {
+    relative.clear();
+    paths::append_relative(relative, cwd, key);
+
+    return base / relative;
+  };
+
+  const auto inside = [&](std::string_view key) {
+    return paths::common_segments(cwd, key) == paths::segment_count(cwd);
+  };
+
+  for (const auto &folder : folders)
+    if (inside(folder))
+      success = target.make_folders(destination(folder)) && success;
+
+  for (const auto &[key, contents] : files) {
+    if (!inside(key))
+      continue;
+
+    const std::filesystem::path path = destination(key);
+    Emitter emitter;
+    emitter.append(contents);
+
+    success = target.make_folders(path.parent_path()) &&
+              target.write(path, emitter, false) && success;
+  }
+
+  return success;
+}